@@ -8,7 +8,7 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f32(
     output: &mut [num_complex::Complex<f32>],
     forward: bool,
     size: usize,
-    twiddles: &[num_complex::Complex<f32>],
+    twiddles: super::StageTwiddles<'_, f32>,
 ) {
     avx_vector! { f32 };
     const RADIX: usize = 4;
@@ -84,7 +84,12 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f32(
         }; // br3 bi3 br3 bi3 br1 bi1 br1 bi1
         let mut out = _mm256_blend_ps(out_lo, out_hi, 0b0011_1100); // br0 bi0 br3 bi3 br1 bi1 br2 bi2
         if size != RADIX {
-            let twiddles = _mm256_loadu_ps(twiddles.as_ptr().add(RADIX * i) as *const _);
+            let mut buffer = [num_complex::Complex::default(); RADIX];
+            let twiddles = twiddles.get(i, 1, RADIX, &mut buffer);
+            let mut twiddles = _mm256_loadu_ps(twiddles.as_ptr() as *const _);
+            if !forward {
+                twiddles = conj!(twiddles);
+            }
             out = mul!(out, twiddles);
         }
         _mm256_storeu_ps(output.as_mut_ptr().add(RADIX * i) as *mut _, out);
@@ -93,13 +98,12 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f32(
 
 #[multiversion::target("[x86|x86_64]+avx")]
 #[inline]
-#[allow(dead_code)]
 pub(crate) unsafe fn radix_4_stride_1_avx_f64(
     input: &[num_complex::Complex<f64>],
     output: &mut [num_complex::Complex<f64>],
     forward: bool,
     size: usize,
-    twiddles: &[num_complex::Complex<f64>],
+    twiddles: super::StageTwiddles<'_, f64>,
 ) {
     avx_vector! { f64 };
     const RADIX: usize = 4;
@@ -107,18 +111,9 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f64(
 
     for i in 0..m {
         // Load
-        let gathered2 = _mm256_set_pd(
-            input.as_ptr().add(3 * m + i).read().im,
-            input.as_ptr().add(3 * m + i).read().re,
-            input.as_ptr().add(2 * m + i).read().im,
-            input.as_ptr().add(2 * m + i).read().re,
-        );
-        let gathered1 = _mm256_set_pd(
-            input.as_ptr().add(m + i).read().im,
-            input.as_ptr().add(m + i).read().re,
-            input.as_ptr().add(i).read().im,
-            input.as_ptr().add(i).read().re,
-        );
+        let load = |k: usize| _mm_loadu_pd(input.as_ptr().add(k * m + i) as *const f64);
+        let gathered1 = _mm256_insertf128_pd(_mm256_castpd128_pd256(load(0)), load(1), 1);
+        let gathered2 = _mm256_insertf128_pd(_mm256_castpd128_pd256(load(2)), load(3), 1);
 
         // first radix 2
         // in vector      |  sorted
@@ -187,8 +182,14 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f64(
             0b1010,
         );
         if size != RADIX {
-            let twiddles1 = _mm256_loadu_pd(twiddles.as_ptr().add(RADIX * i) as *const _);
-            let twiddles2 = _mm256_loadu_pd(twiddles.as_ptr().add(RADIX * i + 2) as *const _);
+            let mut buffer = [num_complex::Complex::default(); RADIX];
+            let twiddles = twiddles.get(i, 1, RADIX, &mut buffer);
+            let mut twiddles1 = _mm256_loadu_pd(twiddles.as_ptr() as *const _);
+            let mut twiddles2 = _mm256_loadu_pd(twiddles.as_ptr().add(2) as *const _);
+            if !forward {
+                twiddles1 = conj!(twiddles1);
+                twiddles2 = conj!(twiddles2);
+            }
             out1 = mul!(out1, twiddles1);
             out2 = mul!(out2, twiddles2);
         }
@@ -197,39 +198,166 @@ pub(crate) unsafe fn radix_4_stride_1_avx_f64(
     }
 }
 
+/// Loads `width!()` complex values separated by `step` into a vector.
+macro_rules! load_transposed {
+    { f32, $from:expr, $step:expr } => {
+        {
+            let from = $from as *const f64;
+            let lo = _mm_loadh_pd(_mm_load_sd(from), from.add($step));
+            let hi = _mm_loadh_pd(_mm_load_sd(from.add(2 * $step)), from.add(3 * $step));
+            _mm256_castpd_ps(_mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1))
+        }
+    };
+    { f64, $from:expr, $step:expr } => {
+        {
+            let from = $from as *const f64;
+            let lo = _mm_loadu_pd(from);
+            let hi = _mm_loadu_pd(from.add(2 * $step));
+            _mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1)
+        }
+    };
+}
+
+/// Stores a vector to `width!()` complex values separated by `step`.
+macro_rules! store_transposed {
+    { f32, $z:expr, $to:expr, $step:expr } => {
+        {
+            let to = $to as *mut f64;
+            let z = _mm256_castps_pd($z);
+            let lo = _mm256_castpd256_pd128(z);
+            let hi = _mm256_extractf128_pd(z, 1);
+            _mm_storel_pd(to, lo);
+            _mm_storeh_pd(to.add($step), lo);
+            _mm_storel_pd(to.add(2 * $step), hi);
+            _mm_storeh_pd(to.add(3 * $step), hi);
+        }
+    };
+    { f64, $z:expr, $to:expr, $step:expr } => {
+        {
+            let to = $to as *mut f64;
+            _mm_storeu_pd(to, _mm256_castpd256_pd128($z));
+            _mm_storeu_pd(to.add(2 * $step), _mm256_extractf128_pd($z, 1));
+        }
+    };
+}
+
+/// Creates a stride-1 radix kernel that vectorizes across butterflies, rather than within a
+/// butterfly.
+///
+/// With a stride of 1, each input of consecutive butterflies is contiguous, so inputs are loaded
+/// as full vectors.  The outputs of each butterfly are contiguous instead, so outputs (and the
+/// twiddles, which are stored in the same order) are transposed with partial loads and stores.
+/// Inverse transforms conjugate the twiddles after loading.
+///
+/// Returns `false`, without performing the stage, if there are fewer butterflies than the vector
+/// width.
+macro_rules! make_stride_1_fn {
+    { $type:ident, $radix:literal, $name:ident, $butterfly:ident } => {
+        #[multiversion::target("[x86|x86_64]+avx")]
+        #[inline]
+        pub(crate) unsafe fn $name(
+            input: &[num_complex::Complex<$type>],
+            output: &mut [num_complex::Complex<$type>],
+            _forward: bool,
+            size: usize,
+            twiddles: super::StageTwiddles<'_, $type>,
+        ) -> bool {
+            avx_vector! { $type };
+            let m = size / $radix;
+            if m < width!() {
+                return false;
+            }
+
+            // Loop over full vectors, with a final overlapping vector
+            for i in (0..((m - 1) / width!()) * width!())
+                .step_by(width!())
+                .chain(core::iter::once(m - width!()))
+            {
+                let mut scratch = [zeroed!(); $radix];
+                for k in 0..$radix {
+                    scratch[k] = load_wide!(input.as_ptr().add(k * m + i));
+                }
+
+                scratch = $butterfly!($type, scratch, _forward);
+                if size != $radix {
+                    let mut buffer = [num_complex::Complex::default(); 4 * $radix];
+                    let twiddles = twiddles.get(i, width!(), $radix, &mut buffer);
+                    for k in 1..$radix {
+                        let mut twiddle = load_transposed!($type, twiddles.as_ptr().add(k), $radix);
+                        if !_forward {
+                            twiddle = conj!(twiddle);
+                        }
+                        scratch[k] = mul!(scratch[k], twiddle);
+                    }
+                }
+
+                for k in 0..$radix {
+                    store_transposed!($type, scratch[k], output.as_mut_ptr().add($radix * i + k), $radix);
+                }
+            }
+            true
+        }
+    };
+}
+
+make_stride_1_fn! { f32, 2, radix_2_stride_1_avx_f32, butterfly2 }
+make_stride_1_fn! { f32, 3, radix_3_stride_1_avx_f32, butterfly3 }
+make_stride_1_fn! { f32, 5, radix_5_stride_1_avx_f32, butterfly5 }
+make_stride_1_fn! { f32, 7, radix_7_stride_1_avx_f32, butterfly7 }
+make_stride_1_fn! { f32, 8, radix_8_stride_1_avx_f32, butterfly8 }
+make_stride_1_fn! { f64, 2, radix_2_stride_1_avx_f64, butterfly2 }
+make_stride_1_fn! { f64, 3, radix_3_stride_1_avx_f64, butterfly3 }
+make_stride_1_fn! { f64, 5, radix_5_stride_1_avx_f64, butterfly5 }
+make_stride_1_fn! { f64, 7, radix_7_stride_1_avx_f64, butterfly7 }
+make_stride_1_fn! { f64, 8, radix_8_stride_1_avx_f64, butterfly8 }
+
 #[macro_export]
 #[doc(hidden)]
 macro_rules! avx_optimization {
     {
-        f32, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
+        interleaved, f32, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
     } => {
-        if $radix == 4 && $stride == 1 {
-            unsafe {
-                crate::autosort::avx_optimization::radix_4_stride_1_avx_f32($input, $output, $forward, $size, $twiddles);
+        $stride == 1 && unsafe {
+            use crate::autosort::avx_optimization::*;
+            match $radix {
+                2 => radix_2_stride_1_avx_f32($input, $output, $forward, $size, $twiddles),
+                3 => radix_3_stride_1_avx_f32($input, $output, $forward, $size, $twiddles),
+                4 => {
+                    radix_4_stride_1_avx_f32($input, $output, $forward, $size, $twiddles);
+                    true
+                }
+                5 => radix_5_stride_1_avx_f32($input, $output, $forward, $size, $twiddles),
+                7 => radix_7_stride_1_avx_f32($input, $output, $forward, $size, $twiddles),
+                8 => radix_8_stride_1_avx_f32($input, $output, $forward, $size, $twiddles),
+                _ => false,
             }
-            true
-        } else {
-            false
         }
     };
     {
-        f64, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
+        interleaved, f64, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
     } => {
-        /*
-        if $radix == 4 && $stride == 1 {
-            unsafe {
-                crate::autosort::avx_optimization::radix_4_stride_1_avx_f64($input, $output, $forward, $size, $twiddles);
+        $stride == 1 && unsafe {
+            use crate::autosort::avx_optimization::*;
+            match $radix {
+                2 => radix_2_stride_1_avx_f64($input, $output, $forward, $size, $twiddles),
+                3 => radix_3_stride_1_avx_f64($input, $output, $forward, $size, $twiddles),
+                4 => {
+                    radix_4_stride_1_avx_f64($input, $output, $forward, $size, $twiddles);
+                    true
+                }
+                5 => radix_5_stride_1_avx_f64($input, $output, $forward, $size, $twiddles),
+                7 => radix_7_stride_1_avx_f64($input, $output, $forward, $size, $twiddles),
+                8 => radix_8_stride_1_avx_f64($input, $output, $forward, $size, $twiddles),
+                _ => false,
             }
-            true
-        } else {
-            false
         }
-        */
-        false
     };
     {
-        $type:ty, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
+        $layout:ident, $type:ty, $radix:literal, $input:ident, $output:ident, $forward:ident, $size:ident, $stride:ident, $twiddles:ident
     } => {
-        false
+        {
+            let _ = $input;
+            false
+        }
     }
 }
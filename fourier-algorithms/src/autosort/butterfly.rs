@@ -63,3 +63,123 @@ macro_rules! butterfly8 {
         }
     }
 }
+
+/// A butterfly for odd radices.
+///
+/// Inputs `k` and `radix - k` are combined into a sum and a difference, so output `m` is
+/// `x[0] + sum(cos * sums) -+ i sum(sin * differences)` and output `radix - m` only differs in the
+/// sign of the imaginary term.  This requires real (rather than complex) multiplications.
+///
+/// `cos` and `sin` contain the values for angles `2 pi j / radix` for `j` in `1..=(radix - 1) / 2`.
+#[macro_export]
+#[doc(hidden)]
+macro_rules! butterfly_odd {
+    { $type:ty, $input:tt, $forward:tt, $radix:literal, $cos:expr, $sin:expr } => {
+        {
+            const HALF: usize = ($radix - 1) / 2;
+            let cos: [f64; HALF] = $cos;
+            let sin: [f64; HALF] = $sin;
+            let mut sums = [zeroed!(); HALF];
+            let mut differences = [zeroed!(); HALF];
+            for k in 0..HALF {
+                sums[k] = add!($input[k + 1], $input[$radix - 1 - k]);
+                differences[k] = sub!($input[k + 1], $input[$radix - 1 - k]);
+            }
+            let mut output = [zeroed!(); $radix];
+            output[0] = $input[0];
+            for k in 0..HALF {
+                output[0] = add!(output[0], sums[k]);
+            }
+            for m in 1..=HALF {
+                let mut real = $input[0];
+                let mut imag = zeroed!();
+                for k in 1..=HALF {
+                    let j = (m * k) % $radix;
+                    let (c, s) = if j <= HALF {
+                        (cos[j - 1], sin[j - 1])
+                    } else {
+                        (cos[$radix - j - 1], -sin[$radix - j - 1])
+                    };
+                    real = add!(real, scale!(sums[k - 1], c as $type));
+                    imag = add!(imag, scale!(differences[k - 1], s as $type));
+                }
+                let rotated = rotate!(imag, !$forward);
+                output[m] = add!(real, rotated);
+                output[$radix - m] = sub!(real, rotated);
+            }
+            output
+        }
+    }
+}
+
+#[macro_export]
+#[doc(hidden)]
+macro_rules! butterfly5 {
+    { $type:ty, $input:tt, $forward:tt } => {
+        butterfly_odd!(
+            $type,
+            $input,
+            $forward,
+            5,
+            [0.30901699437494745, -0.8090169943749473],
+            [0.9510565162951535, 0.5877852522924732]
+        )
+    }
+}
+
+#[macro_export]
+#[doc(hidden)]
+macro_rules! butterfly7 {
+    { $type:ty, $input:tt, $forward:tt } => {
+        butterfly_odd!(
+            $type,
+            $input,
+            $forward,
+            7,
+            [0.6234898018587336, -0.22252093395631434, -0.900968867902419],
+            [0.7818314824680298, 0.9749279121818236, 0.43388373911755823]
+        )
+    }
+}
+
+/// Computes a butterfly for an odd radix that is only known at runtime.
+///
+/// This is the same algorithm as `butterfly_odd`, but `roots` contains the `radix` roots of unity
+/// for the transform direction, rather than constant tables.  The sums and differences overwrite
+/// `input`, and the result is written to `output`.
+#[macro_export]
+#[doc(hidden)]
+macro_rules! butterfly_generic {
+    { $type:ty, $input:tt, $output:tt, $radix:expr, $roots:expr, $forward:expr } => {
+        {
+            let radix = $radix;
+            let half = (radix - 1) / 2;
+            $output[0] = $input[0];
+            for k in 1..=half {
+                let sum = add!($input[k], $input[radix - k]);
+                let difference = sub!($input[k], $input[radix - k]);
+                $input[k] = sum;
+                $input[radix - k] = difference;
+                $output[0] = add!($output[0], sum);
+            }
+            for m in 1..=half {
+                let mut real = $input[0];
+                let mut imag = zeroed!();
+                let mut j = 0;
+                for k in 1..=half {
+                    j += m;
+                    if j >= radix {
+                        j -= radix;
+                    }
+                    let root = $roots[j];
+                    real = add!(real, scale!($input[k], root.re));
+                    imag = add!(imag, scale!($input[radix - k], root.im));
+                }
+                // The roots are forward, so the inverse rotates the other way
+                let rotated = rotate!(imag, $forward);
+                $output[m] = add!(real, rotated);
+                $output[radix - m] = sub!(real, rotated);
+            }
+        }
+    }
+}
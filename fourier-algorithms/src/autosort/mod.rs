@@ -6,10 +6,12 @@ mod butterfly;
 #[macro_use]
 mod avx_optimization;
 
+use crate::batch::{check_batch, gather, scatter};
 use crate::fft::{Fft, Transform};
 use crate::float::FftFloat;
 use crate::twiddle::compute_twiddle;
-use core::cell::RefCell;
+use crate::vector::split::Split;
+use crate::work::allocate_work;
 use core::marker::PhantomData;
 use num_complex::Complex;
 use num_traits::One as _;
@@ -17,42 +19,252 @@ use num_traits::One as _;
 #[cfg(not(feature = "std"))]
 use num_traits::Float as _; // enable sqrt without std
 
-const NUM_RADICES: usize = 5;
-const RADICES: [usize; NUM_RADICES] = [4, 8, 4, 3, 2];
+/// The number of fixed radix stage types.
+pub const NUM_RADICES: usize = 7;
+
+/// The fixed radices, in stage order.  Radix counts refer to these radices.
+pub const RADICES: [usize; NUM_RADICES] = [4, 8, 4, 7, 5, 3, 2];
+
+/// The largest odd prime radix supported by the generic radix stages.
+pub const MAX_GENERIC_RADIX: usize = 61;
+
+/// The maximum number of generic radix stages.  Generic radices are at least 11, and
+/// `11^19 > 2^64`.
+pub const MAX_GENERIC_STAGES: usize = 18;
+
+/// Returns the shift of the two-level twiddle table of a compact stage with `m` butterflies.
+///
+/// The fine table has `1 << shift` entries, which is at least the number of coarse entries.
+fn compact_shift(m: usize) -> u32 {
+    let mut shift = 0;
+    while (m - 1) >> (2 * shift) > 0 {
+        shift += 1;
+    }
+    shift
+}
 
 /// Initializes twiddles.
+///
+/// Each generic radix stage is followed by the `radix` roots of unity used by its butterfly.
+/// Only the forward twiddles are stored; inverse transforms use their conjugates.
+///
+/// If `compact` is true, fixed radix stages store a two-level table of the base twiddle of each
+/// butterfly instead, as described by `StageTwiddles`.
 fn initialize_twiddles<T: FftFloat, E: Extend<Complex<T>>>(
     mut size: usize,
     counts: [usize; NUM_RADICES],
-    forward_twiddles: &mut E,
-    inverse_twiddles: &mut E,
+    generic_radices: [usize; MAX_GENERIC_STAGES],
+    compact: bool,
+    twiddles: &mut E,
 ) {
-    let mut stride = 1;
-    for (radix, count) in RADICES.iter().zip(&counts) {
-        for _ in 0..*count {
-            let m = size / radix;
+    let fixed = RADICES
+        .iter()
+        .zip(&counts)
+        .flat_map(|(radix, count)| core::iter::repeat(*radix).take(*count));
+    let generic = generic_radices
+        .iter()
+        .copied()
+        .take_while(|radix| *radix != 0);
+    for (stage, radix) in fixed.chain(generic).enumerate() {
+        let m = size / radix;
+        let generic = stage >= counts.iter().sum();
+        if compact && !generic {
+            let shift = compact_shift(m);
+            for i in 0..(m + (1 << shift) - 1) >> shift {
+                twiddles.extend(core::iter::once(compute_twiddle(i << shift, size, true)));
+            }
+            for i in 0..1 << shift {
+                twiddles.extend(core::iter::once(compute_twiddle(i, size, true)));
+            }
+        } else {
             for i in 0..m {
-                forward_twiddles.extend(core::iter::once(Complex::<T>::one()));
-                inverse_twiddles.extend(core::iter::once(Complex::<T>::one()));
-                for j in 1..*radix {
-                    forward_twiddles.extend(core::iter::once(compute_twiddle(i * j, size, true)));
-                    inverse_twiddles.extend(core::iter::once(compute_twiddle(i * j, size, false)));
+                twiddles.extend(core::iter::once(Complex::<T>::one()));
+                for j in 1..radix {
+                    twiddles.extend(core::iter::once(compute_twiddle(i * j, size, true)));
+                }
+            }
+        }
+        if generic {
+            for j in 0..radix {
+                twiddles.extend(core::iter::once(compute_twiddle(j, radix, true)));
+            }
+        }
+        size /= radix;
+    }
+}
+
+/// The twiddles of a single fixed radix stage.
+#[derive(Copy, Clone)]
+pub(crate) enum StageTwiddles<'a, T> {
+    /// Twiddle `k` of butterfly `i` is stored at `radix * i + k`.
+    Full(&'a [Complex<T>]),
+    /// Twiddle `k` of butterfly `i` is the `k`th power of the base twiddle `w^i`, which is
+    /// computed as `coarse[i >> shift] * fine[i & mask]`.
+    ///
+    /// This stores roughly `2 * sqrt(m)` twiddles for `m` butterflies, rather than `radix * m`.
+    Compact {
+        coarse: &'a [Complex<T>],
+        fine: &'a [Complex<T>],
+        shift: u32,
+    },
+}
+
+impl<'a, T: FftFloat> StageTwiddles<'a, T> {
+    /// Splits the twiddles of a stage from the front of `twiddles`.
+    fn split(
+        twiddles: &'a [Complex<T>],
+        size: usize,
+        radix: usize,
+        compact: bool,
+    ) -> (Self, &'a [Complex<T>]) {
+        let m = size / radix;
+        if compact {
+            let shift = compact_shift(m);
+            let (coarse, rest) = twiddles.split_at((m + (1 << shift) - 1) >> shift);
+            let (fine, rest) = rest.split_at(1 << shift);
+            (
+                Self::Compact {
+                    coarse,
+                    fine,
+                    shift,
+                },
+                rest,
+            )
+        } else {
+            let (stage, rest) = twiddles.split_at(size);
+            (Self::Full(stage), rest)
+        }
+    }
+
+    /// Returns the twiddles of `count` consecutive butterflies starting at butterfly `i`, in the
+    /// full layout.  Compact twiddles are computed in `buffer`.
+    #[inline(always)]
+    pub(crate) fn get<'b>(
+        &'b self,
+        i: usize,
+        count: usize,
+        radix: usize,
+        buffer: &'b mut [Complex<T>],
+    ) -> &'b [Complex<T>] {
+        match self {
+            Self::Full(twiddles) => &twiddles[radix * i..radix * (i + count)],
+            Self::Compact {
+                coarse,
+                fine,
+                shift,
+            } => {
+                for (j, twiddles) in buffer.chunks_exact_mut(radix).take(count).enumerate() {
+                    let index = i + j;
+                    twiddles[0] = Complex::one();
+                    twiddles[1] = coarse[index >> shift] * fine[index & ((1 << shift) - 1)];
+
+                    // Multiply lower powers, so the error grows with the log of the power
+                    for k in 2..radix {
+                        twiddles[k] = twiddles[k / 2] * twiddles[k - k / 2];
+                    }
                 }
+                &buffer[..radix * count]
             }
-            size /= radix;
-            stride *= radix;
         }
     }
 }
 
-/// Implements a mixed-radix Stockham autosort algorithm for multiples of 2 and 3.
+/// A buffer loaded or stored by a stage.
+#[derive(Copy, Clone, PartialEq, Eq)]
+enum Buffer {
+    Input,
+    Output,
+    Work,
+}
+
+/// Chooses the buffers loaded and stored by each stage.
+///
+/// Stages alternate between the output and work buffers, starting from the input (when
+/// transforming out-of-place) and ending in the output, so the result is never copied.  The final
+/// stage loads and stores the same elements, so when transforming in-place with an odd number of
+/// stages, it is applied in-place.
+struct StageBuffers {
+    source: Buffer,
+    remaining: usize,
+}
+
+impl StageBuffers {
+    fn new(out_of_place: bool, stages: usize) -> Self {
+        if out_of_place {
+            Self {
+                source: Buffer::Input,
+                remaining: stages,
+            }
+        } else {
+            Self {
+                source: Buffer::Output,
+                remaining: stages - stages % 2,
+            }
+        }
+    }
+
+    /// Returns the buffers of the next stage.  No input indicates an in-place stage.
+    #[inline(always)]
+    fn next<'b, B: ?Sized>(
+        &mut self,
+        input: Option<&'b B>,
+        output: &'b mut B,
+        work: &'b mut B,
+    ) -> (Option<&'b B>, &'b mut B) {
+        let destination = if self.remaining % 2 == 1 || self.remaining == 0 {
+            Buffer::Output
+        } else {
+            Buffer::Work
+        };
+        let source = core::mem::replace(&mut self.source, destination);
+        self.remaining = self.remaining.saturating_sub(1);
+        match (source, destination) {
+            (Buffer::Input, Buffer::Output) => (input, output),
+            (Buffer::Input, Buffer::Work) => (input, work),
+            (Buffer::Output, Buffer::Work) => (Some(output), work),
+            (Buffer::Work, Buffer::Output) => (Some(work), output),
+            (Buffer::Output, Buffer::Output) => (None, output),
+            _ => unreachable!(),
+        }
+    }
+}
+
+/// Returns the pointer loaded by a stage: the input, or the output of an in-place stage.
+macro_rules! input_ptr {
+    { interleaved, $input:ident, $output_ptr:ident } => {
+        match $input {
+            Some(input) => input.as_ptr(),
+            None => $output_ptr as *const _,
+        }
+    };
+    { split, $input:ident, $output_ptr:ident } => {
+        match $input {
+            Some(input) => input.as_ptr(),
+            None => crate::vector::split::SplitPtr {
+                real: $output_ptr.real,
+                imag: $output_ptr.imag,
+            },
+        }
+    };
+}
+
+/// Implements a mixed-radix Stockham autosort algorithm for multiples of 2, 3, 5, and 7.
+///
+/// Other odd prime factors, up to a configurable maximum radix, are performed by generic radix
+/// stages.  These stages compute each butterfly directly, so they are slower than the fixed
+/// radices, but much faster than falling back to Bluestein's algorithm.
+///
+/// The work buffer is not owned by the transform.  Each transform either uses a caller-supplied
+/// scratch buffer or allocates a `Work` buffer with `Default` and `Extend`, so a single `Autosort`
+/// may be shared between threads.
 pub struct Autosort<T, Twiddles, Work> {
     size: usize,
     counts: [usize; NUM_RADICES],
-    forward_twiddles: Twiddles,
-    inverse_twiddles: Twiddles,
-    work: RefCell<Work>,
+    generic_radices: [usize; MAX_GENERIC_STAGES],
+    twiddles: Twiddles,
+    compact: bool,
     real_type: PhantomData<T>,
+    work_type: PhantomData<Work>,
 }
 
 impl<T, Twiddles, Work> Autosort<T, Twiddles, Work> {
@@ -61,85 +273,221 @@ impl<T, Twiddles, Work> Autosort<T, Twiddles, Work> {
         self.counts
     }
 
-    /// Create a new transform generator from parts.  Twiddles factors and work must be the correct
-    /// size.
+    /// Return the generic radices, in stage order.  Unused stages are zero.
+    pub fn generic_radices(&self) -> [usize; MAX_GENERIC_STAGES] {
+        self.generic_radices
+    }
+
+    /// Return true if the twiddles are stored in the compact layout.
+    pub fn is_compact(&self) -> bool {
+        self.compact
+    }
+
+    /// Create a new transform generator from parts.  Twiddles factors must be the correct size,
+    /// in the full layout.
     pub unsafe fn new_from_parts(
         size: usize,
         counts: [usize; NUM_RADICES],
-        forward_twiddles: Twiddles,
-        inverse_twiddles: Twiddles,
-        work: Work,
+        generic_radices: [usize; MAX_GENERIC_STAGES],
+        twiddles: Twiddles,
     ) -> Self {
         Self {
             size,
             counts,
-            forward_twiddles,
-            inverse_twiddles,
-            work: RefCell::new(work),
+            generic_radices,
+            twiddles,
+            compact: false,
             real_type: PhantomData,
+            work_type: PhantomData,
         }
     }
 }
 
-impl<T, Twiddles: AsRef<[Complex<T>]>, Work: AsRef<[Complex<T>]>> Autosort<T, Twiddles, Work> {
-    /// Return the forward and inverse twiddle factors.
-    pub fn twiddles(&self) -> (&[Complex<T>], &[Complex<T>]) {
-        (
-            self.forward_twiddles.as_ref(),
-            self.inverse_twiddles.as_ref(),
-        )
+impl<T, Twiddles: AsRef<[Complex<T>]>, Work> Autosort<T, Twiddles, Work> {
+    /// Return the forward twiddle factors.  The inverse twiddle factors are their conjugates.
+    pub fn twiddles(&self) -> &[Complex<T>] {
+        self.twiddles.as_ref()
     }
+}
 
-    /// Return the work buffer size.
-    pub fn work_size(&self) -> usize {
-        self.work.borrow().as_ref().len()
+/// Returns the number of stages of each radix and the generic radices, or `None` if the size is not
+/// supported.
+fn factorize(
+    size: usize,
+    max_radix: usize,
+) -> Option<([usize; NUM_RADICES], [usize; MAX_GENERIC_STAGES])> {
+    if size == 0 {
+        return None;
+    }
+    let mut current_size = size;
+    let mut counts = [0usize; NUM_RADICES];
+    if current_size % RADICES[0] == 0 {
+        current_size /= RADICES[0];
+        counts[0] = 1;
+    }
+    for (count, radix) in counts.iter_mut().zip(&RADICES).skip(1) {
+        while current_size % radix == 0 {
+            current_size /= radix;
+            *count += 1;
+        }
     }
+
+    // Any composite divisor has a smaller prime factor that was already removed, so only primes
+    // divide the remaining size
+    let mut generic_radices = [0usize; MAX_GENERIC_STAGES];
+    let mut stage = 0;
+    let mut radix = 11;
+    while current_size != 1 && radix <= core::cmp::min(max_radix, MAX_GENERIC_RADIX) {
+        while current_size % radix == 0 {
+            current_size /= radix;
+            generic_radices[stage] = radix;
+            stage += 1;
+        }
+        radix += 2;
+    }
+
+    if current_size == 1 {
+        Some((counts, generic_radices))
+    } else {
+        None
+    }
+}
+
+/// Returns true if the size can be performed by [`Autosort`] with the default maximum radix.
+///
+/// [`Autosort`]: struct.Autosort.html
+pub fn is_autosort_size(size: usize) -> bool {
+    factorize(size, MAX_GENERIC_RADIX).is_some()
 }
 
-impl<T: FftFloat, Twiddles: Default + Extend<Complex<T>>, Work: Default + Extend<Complex<T>>>
-    Autosort<T, Twiddles, Work>
-{
+/// Returns every factorization of the size supported by [`Autosort`], as radix counts and generic
+/// radices.
+///
+/// The factors of two may be performed by any combination of radix-8, radix-4 and radix-2 stages
+/// (with at most one radix-2 stage), and a radix-4 stage may be performed either first or after
+/// the radix-8 stages.  The other factors are the same for every factorization.  The first
+/// factorization is the one chosen by [`Autosort::new`].
+///
+/// [`Autosort`]: struct.Autosort.html
+/// [`Autosort::new`]: struct.Autosort.html#method.new
+pub fn autosort_factorizations(
+    size: usize,
+) -> impl Iterator<Item = ([usize; NUM_RADICES], [usize; MAX_GENERIC_STAGES])> {
+    factorize(size, MAX_GENERIC_RADIX)
+        .into_iter()
+        .flat_map(|(counts, generic_radices)| {
+            let twos = 2 * counts[0] + 3 * counts[1] + 2 * counts[2] + counts[6];
+            let alternatives = (0..=1).flat_map(move |first| {
+                (0..=twos / 3).flat_map(move |eights| {
+                    (0..=1).filter_map(move |two| {
+                        let fours = twos.checked_sub(2 * first + 3 * eights + two)?;
+                        let mut alternative = counts;
+                        alternative[0] = first;
+                        alternative[1] = eights;
+                        alternative[2] = fours / 2;
+                        alternative[6] = two;
+                        if fours % 2 == 0 && alternative != counts {
+                            Some(alternative)
+                        } else {
+                            None
+                        }
+                    })
+                })
+            });
+            core::iter::once(counts)
+                .chain(alternatives)
+                .map(move |counts| (counts, generic_radices))
+        })
+}
+
+impl<T: FftFloat, Twiddles: Default + Extend<Complex<T>>, Work> Autosort<T, Twiddles, Work> {
     /// Create a new Stockham autosort generator.  Returns `None` if the transform size cannot be
     /// performed.
+    ///
+    /// Prime factors up to `MAX_GENERIC_RADIX` are supported.
     pub fn new(size: usize) -> Option<Self> {
-        let mut current_size = size;
-        let mut counts = [0usize; NUM_RADICES];
-        if current_size % RADICES[0] == 0 {
-            current_size /= RADICES[0];
-            counts[0] = 1;
+        Self::new_with_max_radix(size, MAX_GENERIC_RADIX)
+    }
+
+    /// Create a new Stockham autosort generator, with prime factors up to `max_radix`.  Returns
+    /// `None` if the transform size cannot be performed.
+    ///
+    /// The cost of a generic radix stage grows with the radix, so a lower maximum radix may be
+    /// used to prefer other algorithms for sizes with large prime factors.  The maximum radix is
+    /// limited to `MAX_GENERIC_RADIX`.
+    pub fn new_with_max_radix(size: usize, max_radix: usize) -> Option<Self> {
+        let (counts, generic_radices) = factorize(size, max_radix)?;
+        Self::new_with_factors(size, counts, generic_radices)
+    }
+
+    /// Create a new Stockham autosort generator with the specified radix counts and generic
+    /// radices, such as those returned by [`autosort_factorizations`].  Returns `None` if the
+    /// factors are unsupported or their product is not the size.
+    ///
+    /// [`autosort_factorizations`]: fn.autosort_factorizations.html
+    pub fn new_with_factors(
+        size: usize,
+        counts: [usize; NUM_RADICES],
+        generic_radices: [usize; MAX_GENERIC_STAGES],
+    ) -> Option<Self> {
+        Self::new_with_layout(size, counts, generic_radices, false)
+    }
+
+    /// Create a new Stockham autosort generator that stores compact twiddle tables.  Returns
+    /// `None` if the transform size cannot be performed.
+    ///
+    /// Rather than storing every twiddle factor, each fixed radix stage stores a small two-level
+    /// table of roughly `2 * sqrt(size)` twiddles, and the rest are computed during the transform.
+    /// This reduces the memory used by large transforms by orders of magnitude, at the cost of
+    /// some throughput and slightly larger rounding error.  Generic radix stages always store
+    /// every twiddle factor.
+    pub fn new_compact(size: usize) -> Option<Self> {
+        let (counts, generic_radices) = factorize(size, MAX_GENERIC_RADIX)?;
+        Self::new_with_layout(size, counts, generic_radices, true)
+    }
+
+    fn new_with_layout(
+        size: usize,
+        counts: [usize; NUM_RADICES],
+        generic_radices: [usize; MAX_GENERIC_STAGES],
+        compact: bool,
+    ) -> Option<Self> {
+        let mut product = 1usize;
+        for (radix, count) in RADICES.iter().zip(&counts) {
+            product = product.checked_mul(radix.checked_pow(*count as u32)?)?;
         }
-        for (count, radix) in counts.iter_mut().zip(&RADICES).skip(1) {
-            while current_size % radix == 0 {
-                current_size /= radix;
-                *count += 1;
+        for radix in generic_radices.iter().take_while(|radix| **radix != 0) {
+            if *radix < 11 || *radix > MAX_GENERIC_RADIX || !crate::is_prime(*radix) {
+                return None;
             }
+            product = product.checked_mul(*radix)?;
         }
-        if current_size == 1 {
-            let mut forward_twiddles = Twiddles::default();
-            let mut inverse_twiddles = Twiddles::default();
-            initialize_twiddles(size, counts, &mut forward_twiddles, &mut inverse_twiddles);
-            let mut work = Work::default();
-            work.extend(core::iter::repeat(Complex::default()).take(size));
-            Some(Self {
-                size,
-                counts,
-                forward_twiddles,
-                inverse_twiddles,
-                work: RefCell::new(work),
-                real_type: PhantomData,
-            })
-        } else {
-            None
+        if product != size {
+            return None;
         }
+
+        let mut twiddles = Twiddles::default();
+        initialize_twiddles(size, counts, generic_radices, compact, &mut twiddles);
+        Some(Self {
+            size,
+            counts,
+            generic_radices,
+            twiddles,
+            compact,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        })
     }
 }
 
 macro_rules! implement {
     {
-        $type:ty, $apply:ident
+        $type:ty, $apply:ident, $apply_batch:ident, $apply_split:ident
     } => {
-        impl<Twiddles: AsRef<[Complex<$type>]>, Work: AsMut<[Complex<$type>]>> Fft
-            for Autosort<$type, Twiddles, Work>
+        impl<
+                Twiddles: AsRef<[Complex<$type>]>,
+                Work: Default + Extend<Complex<$type>> + AsMut<[Complex<$type>]>,
+            > Fft for Autosort<$type, Twiddles, Work>
         {
             type Real = $type;
 
@@ -147,137 +495,505 @@ macro_rules! implement {
                 self.size
             }
 
+            fn scratch_size(&self) -> usize {
+                self.size
+            }
+
             fn transform_in_place(&self, input: &mut [Complex<$type>], transform: Transform) {
-                let mut work = self.work.borrow_mut();
-                let twiddles = if transform.is_forward() {
-                    &self.forward_twiddles
-                } else {
-                    &self.inverse_twiddles
-                };
+                let mut work = allocate_work::<$type, Work>(self.scratch_size());
+                self.transform_in_place_with_scratch(input, work.as_mut(), transform);
+            }
+
+            fn transform_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<$type>],
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
                 $apply(
+                    None,
                     input,
+                    &mut scratch[..self.size],
+                    &self.counts,
+                    &self.generic_radices,
+                    self.twiddles.as_ref(),
+                    self.compact,
+                    self.size,
+                    transform,
+                    None,
+                );
+            }
+
+            fn fft_multiply_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<$type>],
+                scratch: &mut [Complex<$type>],
+                factors: &[Complex<$type>],
+                conjugate: bool,
+            ) {
+                assert_eq!(factors.len(), self.size);
+
+                // Generic radices are not fused, so multiply after the transform
+                if self.size == 1 || self.generic_radices[0] != 0 {
+                    self.transform_in_place_with_scratch(input, scratch, Transform::Fft);
+                    for (x, factor) in input.iter_mut().zip(factors) {
+                        *x *= if conjugate { factor.conj() } else { *factor };
+                    }
+                    return;
+                }
+
+                $apply(
+                    None,
+                    input,
+                    &mut scratch[..self.size],
+                    &self.counts,
+                    &self.generic_radices,
+                    self.twiddles.as_ref(),
+                    self.compact,
+                    self.size,
+                    Transform::Fft,
+                    Some((factors, conjugate)),
+                );
+            }
+
+            fn transform(
+                &self,
+                input: &[Complex<$type>],
+                output: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.scratch_size());
+                self.transform_with_scratch(input, output, work.as_mut(), transform);
+            }
+
+            fn transform_with_scratch(
+                &self,
+                input: &[Complex<$type>],
+                output: &mut [Complex<$type>],
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                $apply(
+                    Some(input),
+                    output,
+                    &mut scratch[..self.size],
+                    &self.counts,
+                    &self.generic_radices,
+                    self.twiddles.as_ref(),
+                    self.compact,
+                    self.size,
+                    transform,
+                    None,
+                );
+            }
+
+            fn transform_batch_in_place(
+                &self,
+                input: &mut [Complex<$type>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.batch_scratch_size());
+                self.transform_batch_in_place_with_scratch(
+                    input,
+                    count,
+                    stride,
+                    distance,
                     work.as_mut(),
+                    transform,
+                );
+            }
+
+            fn transform_batch_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<$type>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                check_batch(self.size, input.len(), count, stride, distance);
+                let (buffer, work) = scratch.split_at_mut(self.size);
+                $apply_batch(
+                    input,
+                    count,
+                    stride,
+                    distance,
+                    buffer,
+                    &mut work[..self.size],
                     &self.counts,
-                    twiddles.as_ref(),
+                    &self.generic_radices,
+                    self.twiddles.as_ref(),
+                    self.compact,
                     self.size,
                     transform,
                 );
             }
+
+            fn split_scratch_size(&self) -> usize {
+                self.size
+            }
+
+            fn transform_split_in_place(
+                &self,
+                real: &mut [$type],
+                imag: &mut [$type],
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.split_scratch_size());
+                self.transform_split_in_place_with_scratch(real, imag, work.as_mut(), transform);
+            }
+
+            fn transform_split_in_place_with_scratch(
+                &self,
+                real: &mut [$type],
+                imag: &mut [$type],
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                $apply_split(
+                    None,
+                    &mut Split::new(real, imag),
+                    &mut Split::from_complex(scratch, self.size),
+                    &self.counts,
+                    &self.generic_radices,
+                    self.twiddles.as_ref(),
+                    self.compact,
+                    self.size,
+                    transform,
+                    None,
+                );
+            }
         }
     }
 }
-implement! { f32, apply_stages_f32 }
-implement! { f64, apply_stages_f64 }
+implement! { f32, apply_stages_f32, apply_batch_f32, apply_split_stages_f32 }
+implement! { f64, apply_stages_f64, apply_batch_f64, apply_split_stages_f64 }
 
-/// This macro creates two modules, `radix_f32` and `radix_f64`, containing the radix application
-/// functions for each radix.
-macro_rules! make_radix_fns {
+/// This macro creates the radix application function for generic odd radices.
+///
+/// The stage twiddles are followed by the `radix` roots of unity used by the butterfly.
+macro_rules! make_generic_radix_fn {
     {
-        @impl $type:ident, $wide:literal, $radix:literal, $name:ident, $butterfly:ident
+        $layout:ident, $buf:ty, $type:ident, $wide:literal, $name:ident
     } => {
+        crate::multiversion_avx512! {
+            #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+            #[clone(target = "[x86|x86_64]+avx")]
+            #[clone(target = "[x86|x86_64]+sse3")]
+            #[inline]
+            pub fn $name(
+                input: Option<&$buf>,
+                output: &mut $buf,
+                radix: usize,
+                forward: bool,
+                size: usize,
+                stride: usize,
+                cached_twiddles: &[num_complex::Complex<$type>],
+                scale: Option<$type>,
+            ) {
+                #[target_cfg(target = "[x86|x86_64]+avx+avx2+fma+avx512f")]
+                crate::vector_backend! { $layout, avx512, $type };
 
-        #[multiversion::multiversion]
-        #[clone(target = "[x86|x86_64]+avx")]
-        #[inline]
-        pub fn $name(
-            input: &[num_complex::Complex<$type>],
-            output: &mut [num_complex::Complex<$type>],
-            _forward: bool,
-            size: usize,
-            stride: usize,
-            cached_twiddles: &[num_complex::Complex<$type>],
-        ) {
-            #[target_cfg(target = "[x86|x86_64]+avx")]
-            crate::avx_vector! { $type };
-
-            #[target_cfg(not(target = "[x86|x86_64]+avx"))]
-            crate::generic_vector! { $type };
-
-            #[target_cfg(target = "[x86|x86_64]+avx")]
-            {
-                if !$wide && crate::avx_optimization!($type, $radix, input, output, _forward, size, stride, cached_twiddles) {
-                    return
-                }
-            }
+                #[target_cfg(all(target = "[x86|x86_64]+avx+avx2+fma", not(target = "[x86|x86_64]+avx+avx2+fma+avx512f")))]
+                crate::vector_backend! { $layout, fma, $type };
 
-            let m = size / $radix;
+                #[target_cfg(all(target = "[x86|x86_64]+avx", not(target = "[x86|x86_64]+avx+avx2+fma")))]
+                crate::vector_backend! { $layout, avx, $type };
 
-            let (full_count, final_offset) = if $wide {
-                (Some(((stride - 1) / width!()) * width!()), Some(stride - width!()))
-            } else {
-                (None, None)
-            };
+                #[target_cfg(all(target = "[x86|x86_64]+sse3", not(target = "[x86|x86_64]+avx")))]
+                crate::vector_backend! { $layout, sse, $type };
 
-            for i in 0..m {
-                // Load twiddle factors
-                if $wide {
-                    let twiddles = {
-                        let mut twiddles = [zeroed!(); $radix];
-                        for k in 1..$radix {
-                            twiddles[k] = unsafe {
-                                broadcast!(cached_twiddles.as_ptr().add(i * $radix + k).read())
-                            };
+                #[target_cfg(not(any(target = "[x86|x86_64]+avx", target = "[x86|x86_64]+sse3")))]
+                crate::vector_backend! { $layout, generic, $type };
+
+                assert!(radix <= super::MAX_GENERIC_RADIX);
+
+                let m = size / radix;
+
+                // In-place stages load from the output, which is only valid for the final stage
+                debug_assert!(input.is_some() || m == 1);
+                let output_ptr = output.as_mut_ptr();
+                let input_ptr = input_ptr!($layout, input, output_ptr);
+                let roots = &cached_twiddles[size..size + radix];
+
+                let (full_count, final_offset) = if $wide {
+                    (Some(((stride - 1) / width!()) * width!()), Some(stride - width!()))
+                } else {
+                    (None, None)
+                };
+
+                let mut scratch = [zeroed!(); super::MAX_GENERIC_RADIX];
+                let mut butterfly = [zeroed!(); super::MAX_GENERIC_RADIX];
+                let mut twiddles = [zeroed!(); super::MAX_GENERIC_RADIX];
+                for i in 0..m {
+                    for (k, twiddle) in cached_twiddles[i * radix..(i + 1) * radix].iter().enumerate() {
+                        twiddles[k] = broadcast!(if forward { *twiddle } else { twiddle.conj() });
+                    }
+                    if $wide {
+                        // Loop over full vectors, with a final overlapping vector.  In-place stages store
+                        // the overlapping vector last, after the vectors it overlaps have been loaded.
+                        let mut deferred = None;
+                        for j in core::iter::once(final_offset.unwrap())
+                            .chain((0..full_count.unwrap()).step_by(width!()))
+                        {
+                            // Load full vectors
+                            let load = unsafe { input_ptr.add(j + stride * i) };
+                            for k in 0..radix {
+                                scratch[k] = unsafe { load_wide!(load.add(stride * k * m)) };
+                            }
+
+                            // Butterfly with optional twiddles
+                            butterfly_generic!($type, scratch, butterfly, radix, roots, forward);
+                            if size != radix {
+                                for k in 1..radix {
+                                    butterfly[k] = mul!(butterfly[k], twiddles[k]);
+                                }
+                            }
+
+                            // Scale the outputs, if this is the final stage of a scaled transform
+                            if let Some(scale) = scale {
+                                for k in 0..radix {
+                                    butterfly[k] = scale!(butterfly[k], scale);
+                                }
+                            }
+
+                            if input.is_none() && deferred.is_none() {
+                                deferred = Some(butterfly);
+                                continue;
+                            }
+
+                            // Store full vectors
+                            let store = unsafe { output_ptr.add(j + radix * stride * i) };
+                            for k in 0..radix {
+                                unsafe { store_wide!(butterfly[k], store.add(stride * k)) };
+                            }
                         }
-                        twiddles
-                    };
-
-                    // Loop over full vectors, with a final overlapping vector
-                    for j in (0..full_count.unwrap())
-                        .step_by(width!())
-                        .chain(core::iter::once(final_offset.unwrap()))
-                    {
-                        // Load full vectors
-                        let mut scratch = [zeroed!(); $radix];
-                        let load = unsafe { input.as_ptr().add(j + stride * i) };
-                        for k in 0..$radix {
-                            scratch[k] = unsafe { load_wide!(load.add(stride * k * m)) };
+                        if let Some(butterfly) = deferred {
+                            let store = unsafe { output_ptr.add(final_offset.unwrap() + radix * stride * i) };
+                            for k in 0..radix {
+                                unsafe { store_wide!(butterfly[k], store.add(stride * k)) };
+                            }
                         }
+                    } else {
+                        let load = unsafe { input_ptr.add(stride * i) };
+                        let store = unsafe { output_ptr.add(radix * stride * i) };
+                        for j in 0..stride {
+                            // Load a single value
+                            for k in 0..radix {
+                                scratch[k] = unsafe { load_narrow!(load.add(stride * k * m + j)) };
+                            }
 
-                        // Butterfly with optional twiddles
-                        scratch = $butterfly!($type, scratch, _forward);
-                        if size != $radix {
-                            for k in 1..$radix {
-                                scratch[k] = mul!(scratch[k], twiddles[k]);
+                            // Butterfly with optional twiddles
+                            butterfly_generic!($type, scratch, butterfly, radix, roots, forward);
+                            if size != radix {
+                                for k in 1..radix {
+                                    butterfly[k] = mul!(butterfly[k], twiddles[k]);
+                                }
+                            }
+
+                            // Scale the outputs, if this is the final stage of a scaled transform
+                            if let Some(scale) = scale {
+                                for k in 0..radix {
+                                    butterfly[k] = scale!(butterfly[k], scale);
+                                }
+                            }
+
+                            // Store a single value
+                            for k in 0..radix {
+                                unsafe { store_narrow!(butterfly[k], store.add(stride * k + j)) };
                             }
                         }
+                    }
+                }
+            }
+        }
+    };
+}
+
+/// This macro creates the modules `radix_f32` and `radix_f64`, containing the radix application
+/// functions for each radix, and `radix_split_f32` and `radix_split_f64` for split-complex data.
+macro_rules! make_radix_fns {
+    {
+        @impl $layout:ident, $buf:ty, $type:ident, $wide:literal, $radix:literal, $name:ident, $butterfly:ident
+    } => {
+
+        crate::multiversion_avx512! {
+            #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+            #[clone(target = "[x86|x86_64]+avx")]
+            #[clone(target = "[x86|x86_64]+sse3")]
+            #[inline]
+            pub fn $name(
+                input: Option<&$buf>,
+                output: &mut $buf,
+                _forward: bool,
+                size: usize,
+                stride: usize,
+                stage_twiddles: super::StageTwiddles<'_, $type>,
+                multiply: Option<(&$buf, bool)>,
+                scale: Option<$type>,
+            ) {
+                #[target_cfg(target = "[x86|x86_64]+avx+avx2+fma+avx512f")]
+                crate::vector_backend! { $layout, avx512, $type };
 
-                        // Store full vectors
-                        let store = unsafe { output.as_mut_ptr().add(j + $radix * stride * i) };
-                        for k in 0..$radix {
-                            unsafe { store_wide!(scratch[k], store.add(stride * k)) };
+                #[target_cfg(all(target = "[x86|x86_64]+avx+avx2+fma", not(target = "[x86|x86_64]+avx+avx2+fma+avx512f")))]
+                crate::vector_backend! { $layout, fma, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+avx", not(target = "[x86|x86_64]+avx+avx2+fma")))]
+                crate::vector_backend! { $layout, avx, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+sse3", not(target = "[x86|x86_64]+avx")))]
+                crate::vector_backend! { $layout, sse, $type };
+
+                #[target_cfg(not(any(target = "[x86|x86_64]+avx", target = "[x86|x86_64]+sse3")))]
+                crate::vector_backend! { $layout, generic, $type };
+
+                #[target_cfg(target = "[x86|x86_64]+avx")]
+                {
+                    if let Some(input) = input {
+                        if !$wide && multiply.is_none() && scale.is_none() && crate::avx_optimization!($layout, $type, $radix, input, output, _forward, size, stride, stage_twiddles) {
+                            return
                         }
                     }
+                }
+
+                let m = size / $radix;
+
+                // In-place stages load from the output, which is only valid for the final stage
+                debug_assert!(input.is_some() || m == 1);
+                let output_ptr = output.as_mut_ptr();
+                let input_ptr = input_ptr!($layout, input, output_ptr);
+
+                let (full_count, final_offset) = if $wide {
+                    (Some(((stride - 1) / width!()) * width!()), Some(stride - width!()))
                 } else {
-                    let twiddles = {
-                        let mut twiddles = [zeroed!(); $radix];
-                        for k in 1..$radix {
-                            twiddles[k] = unsafe {
-                                load_narrow!(cached_twiddles.as_ptr().add(i * $radix + k))
-                            };
-                        }
-                        twiddles
-                    };
-
-                    let load = unsafe { input.as_ptr().add(stride * i) };
-                    let store = unsafe { output.as_mut_ptr().add($radix * stride * i) };
-                    for j in 0..stride {
-                        // Load a single value
-                        let mut scratch = [zeroed!(); $radix];
-                        for k in 0..$radix {
-                            scratch[k] = unsafe { load_narrow!(load.add(stride * k * m + j)) };
-                        }
+                    (None, None)
+                };
 
-                        // Butterfly with optional twiddles
-                        scratch = $butterfly!($type, scratch, _forward);
-                        if size != $radix {
+                for i in 0..m {
+                    // Load twiddle factors
+                    if $wide {
+                        let twiddles = {
+                            let mut twiddles = [zeroed!(); $radix];
+                            let mut buffer = [num_complex::Complex::<$type>::default(); $radix];
+                            let cached_twiddles = stage_twiddles.get(i, 1, $radix, &mut buffer);
                             for k in 1..$radix {
-                                scratch[k] = mul!(scratch[k], twiddles[k]);
+                                let twiddle = unsafe { cached_twiddles.as_ptr().add(k).read() };
+                                twiddles[k] = unsafe {
+                                    broadcast!(if _forward { twiddle } else { twiddle.conj() })
+                                };
+                            }
+                            twiddles
+                        };
+
+                        // Loop over full vectors, with a final overlapping vector.  In-place stages store
+                        // the overlapping vector last, after the vectors it overlaps have been loaded.
+                        let mut deferred = None;
+                        for j in core::iter::once(final_offset.unwrap())
+                            .chain((0..full_count.unwrap()).step_by(width!()))
+                        {
+                            // Load full vectors
+                            let mut scratch = [zeroed!(); $radix];
+                            let load = unsafe { input_ptr.add(j + stride * i) };
+                            for k in 0..$radix {
+                                scratch[k] = unsafe { load_wide!(load.add(stride * k * m)) };
+                            }
+
+                            // Butterfly with optional twiddles
+                            scratch = $butterfly!($type, scratch, _forward);
+                            if size != $radix {
+                                for k in 1..$radix {
+                                    scratch[k] = mul!(scratch[k], twiddles[k]);
+                                }
+                            }
+
+                            // Multiply by the factors, if this is the final stage of a fused multiply
+                            if let Some((factors, conjugate)) = multiply {
+                                let factors = unsafe { factors.as_ptr().add(j + $radix * stride * i) };
+                                for k in 0..$radix {
+                                    let factor = unsafe { load_wide!(factors.add(stride * k)) };
+                                    scratch[k] = mul!(scratch[k], if conjugate { conj!(factor) } else { factor });
+                                }
+                            }
+
+                            // Scale the outputs, if this is the final stage of a scaled transform
+                            if let Some(scale) = scale {
+                                for k in 0..$radix {
+                                    scratch[k] = scale!(scratch[k], scale);
+                                }
+                            }
+
+                            if input.is_none() && deferred.is_none() {
+                                deferred = Some(scratch);
+                                continue;
+                            }
+
+                            // Store full vectors
+                            let store = unsafe { output_ptr.add(j + $radix * stride * i) };
+                            for k in 0..$radix {
+                                unsafe { store_wide!(scratch[k], store.add(stride * k)) };
                             }
                         }
+                        if let Some(scratch) = deferred {
+                            let store = unsafe { output_ptr.add(final_offset.unwrap() + $radix * stride * i) };
+                            for k in 0..$radix {
+                                unsafe { store_wide!(scratch[k], store.add(stride * k)) };
+                            }
+                        }
+                    } else {
+                        let twiddles = {
+                            let mut twiddles = [zeroed!(); $radix];
+                            let mut buffer = [num_complex::Complex::<$type>::default(); $radix];
+                            let cached_twiddles = stage_twiddles.get(i, 1, $radix, &mut buffer);
+                            for k in 1..$radix {
+                                let twiddle = unsafe { cached_twiddles.as_ptr().add(k).read() };
+                                twiddles[k] = unsafe {
+                                    broadcast!(if _forward { twiddle } else { twiddle.conj() })
+                                };
+                            }
+                            twiddles
+                        };
+
+                        let load = unsafe { input_ptr.add(stride * i) };
+                        let store = unsafe { output_ptr.add($radix * stride * i) };
+                        for j in 0..stride {
+                            // Load a single value
+                            let mut scratch = [zeroed!(); $radix];
+                            for k in 0..$radix {
+                                scratch[k] = unsafe { load_narrow!(load.add(stride * k * m + j)) };
+                            }
 
-                        // Store a single value
-                        for k in 0..$radix {
-                            unsafe { store_narrow!(scratch[k], store.add(stride * k + j)) };
+                            // Butterfly with optional twiddles
+                            scratch = $butterfly!($type, scratch, _forward);
+                            if size != $radix {
+                                for k in 1..$radix {
+                                    scratch[k] = mul!(scratch[k], twiddles[k]);
+                                }
+                            }
+
+                            // Multiply by the factors, if this is the final stage of a fused multiply
+                            if let Some((factors, conjugate)) = multiply {
+                                let factors = unsafe { factors.as_ptr().add($radix * stride * i) };
+                                for k in 0..$radix {
+                                    let factor = unsafe { load_narrow!(factors.add(stride * k + j)) };
+                                    scratch[k] = mul!(scratch[k], if conjugate { conj!(factor) } else { factor });
+                                }
+                            }
+
+                            // Scale the outputs, if this is the final stage of a scaled transform
+                            if let Some(scale) = scale {
+                                for k in 0..$radix {
+                                    scratch[k] = scale!(scratch[k], scale);
+                                }
+                            }
+
+                            // Store a single value
+                            for k in 0..$radix {
+                                unsafe { store_narrow!(scratch[k], store.add(stride * k + j)) };
+                            }
                         }
                     }
                 }
@@ -287,17 +1003,34 @@ macro_rules! make_radix_fns {
     {
         $([$radix:literal, $wide_name:ident, $narrow_name:ident, $butterfly:ident]),*
     } => {
-        mod radix_f32 {
-        $(
-            make_radix_fns! { @impl f32, true, $radix, $wide_name, $butterfly }
-            make_radix_fns! { @impl f32, false, $radix, $narrow_name, $butterfly }
-        )*
+        make_radix_fns! {
+            @mod radix_f32, interleaved, [num_complex::Complex<f32>], f32,
+            $([$radix, $wide_name, $narrow_name, $butterfly]),*
         }
-        mod radix_f64 {
+        make_radix_fns! {
+            @mod radix_f64, interleaved, [num_complex::Complex<f64>], f64,
+            $([$radix, $wide_name, $narrow_name, $butterfly]),*
+        }
+        make_radix_fns! {
+            @mod radix_split_f32, split, crate::vector::split::Split<'_, f32>, f32,
+            $([$radix, $wide_name, $narrow_name, $butterfly]),*
+        }
+        make_radix_fns! {
+            @mod radix_split_f64, split, crate::vector::split::Split<'_, f64>, f64,
+            $([$radix, $wide_name, $narrow_name, $butterfly]),*
+        }
+    };
+    {
+        @mod $mod:ident, $layout:ident, $buf:ty, $type:ident,
+        $([$radix:literal, $wide_name:ident, $narrow_name:ident, $butterfly:ident]),*
+    } => {
+        mod $mod {
         $(
-            make_radix_fns! { @impl f64, true, $radix, $wide_name, $butterfly }
-            make_radix_fns! { @impl f64, false, $radix, $narrow_name, $butterfly }
+            make_radix_fns! { @impl $layout, $buf, $type, true, $radix, $wide_name, $butterfly }
+            make_radix_fns! { @impl $layout, $buf, $type, false, $radix, $narrow_name, $butterfly }
         )*
+            make_generic_radix_fn! { $layout, $buf, $type, true, radix_generic_wide }
+            make_generic_radix_fn! { $layout, $buf, $type, false, radix_generic_narrow }
         }
     };
 }
@@ -306,99 +1039,194 @@ make_radix_fns! {
     [2, radix_2_wide, radix_2_narrow, butterfly2],
     [3, radix_3_wide, radix_3_narrow, butterfly3],
     [4, radix_4_wide, radix_4_narrow, butterfly4],
+    [5, radix_5_wide, radix_5_narrow, butterfly5],
+    [7, radix_7_wide, radix_7_narrow, butterfly7],
     [8, radix_8_wide, radix_8_narrow, butterfly8]
 }
 
-/// This macro creates the stage application function.
+/// This macro creates the stage application function, and a batched version that dispatches once
+/// for the entire batch.  Split-complex data only has the stage application function.
+///
+/// The stage application function transforms the input into the output, or the output in-place
+/// if there is no input, using the work buffer for intermediate stages.  The final stage applies
+/// the scale of the transform, and optionally multiplies the output by a slice of factors (or their
+/// conjugates), while storing its outputs.
 macro_rules! make_stage_fns {
-    { $type:ident, $name:ident, $radix_mod:ident } => {
-        #[multiversion::multiversion]
-        #[clone(target = "[x86|x86_64]+avx")]
-        #[inline]
-        fn $name(
-            input: &mut [Complex<$type>],
-            output: &mut [Complex<$type>],
-            stages: &[usize; NUM_RADICES],
-            mut twiddles: &[Complex<$type>],
-            mut size: usize,
-            transform: Transform,
-        ) {
-            #[target_cfg(target = "[x86|x86_64]+avx")]
-            crate::avx_vector! { $type };
-
-            #[target_cfg(not(target = "[x86|x86_64]+avx"))]
-            crate::generic_vector! { $type };
-
-            assert_eq!(input.len(), output.len());
-            assert_eq!(size, input.len());
-
-            let mut stride = 1;
-
-            let mut data_in_output = false;
-            for (radix, iterations) in RADICES.iter().zip(stages) {
-                let mut iteration = 0;
-
-                // Use partial loads until the stride is large enough
-                while stride < width! {} && iteration < *iterations {
-                    let (from, to): (&mut _, &mut _) = if data_in_output {
-                        (output, input)
+    { split, $type:ident, $name:ident, $radix_mod:ident } => {
+        make_stage_fns! { @stages split, crate::vector::split::Split<'a, $type>, $type, $name, $radix_mod }
+    };
+    { interleaved, $type:ident, $name:ident, $batch_name:ident, $radix_mod:ident } => {
+        crate::multiversion_avx512! {
+            #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+            #[clone(target = "[x86|x86_64]+avx")]
+            #[clone(target = "[x86|x86_64]+sse3")]
+            #[inline]
+            fn $batch_name(
+                input: &mut [Complex<$type>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                buffer: &mut [Complex<$type>],
+                work: &mut [Complex<$type>],
+                stages: &[usize; NUM_RADICES],
+                generic_radices: &[usize; MAX_GENERIC_STAGES],
+                twiddles: &[Complex<$type>],
+                compact: bool,
+                size: usize,
+                transform: Transform,
+            ) {
+                for i in 0..count {
+                    let vector = &mut input[i * distance..];
+                    if stride == 1 {
+                        dispatch!($name(None, &mut vector[..size], work, stages, generic_radices, twiddles, compact, size, transform, None));
                     } else {
-                        (input, output)
-                    };
-                    match radix {
-                        8 => dispatch!($radix_mod::radix_8_narrow(from, to, transform.is_forward(), size, stride, twiddles)),
-                        4 => dispatch!($radix_mod::radix_4_narrow(from, to, transform.is_forward(), size, stride, twiddles)),
-                        3 => dispatch!($radix_mod::radix_3_narrow(from, to, transform.is_forward(), size, stride, twiddles)),
-                        2 => dispatch!($radix_mod::radix_2_narrow(from, to, transform.is_forward(), size, stride, twiddles)),
-                        _ => unimplemented!("unsupported radix"),
+                        gather(vector, stride, buffer);
+                        dispatch!($name(None, buffer, work, stages, generic_radices, twiddles, compact, size, transform, None));
+                        scatter(buffer, vector, stride);
                     }
-                    size /= radix;
-                    stride *= radix;
-                    twiddles = &twiddles[size * radix..];
-                    iteration += 1;
-                    data_in_output = !data_in_output;
                 }
+            }
+        }
+
+        make_stage_fns! { @stages interleaved, [Complex<$type>], $type, $name, $radix_mod }
+    };
+    { @stages $layout:ident, $buf:ty, $type:ident, $name:ident, $radix_mod:ident } => {
+        crate::multiversion_avx512! {
+            #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+            #[clone(target = "[x86|x86_64]+avx")]
+            #[clone(target = "[x86|x86_64]+sse3")]
+            #[inline]
+            fn $name<'a>(
+                input: Option<&$buf>,
+                output: &mut $buf,
+                work: &mut $buf,
+                stages: &[usize; NUM_RADICES],
+                generic_radices: &[usize; MAX_GENERIC_STAGES],
+                mut twiddles: &[Complex<$type>],
+                compact: bool,
+                mut size: usize,
+                transform: Transform,
+                multiply: Option<(&$buf, bool)>,
+            ) {
+                #[target_cfg(target = "[x86|x86_64]+avx+avx2+fma+avx512f")]
+                crate::vector_backend! { $layout, avx512, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+avx+avx2+fma", not(target = "[x86|x86_64]+avx+avx2+fma+avx512f")))]
+                crate::vector_backend! { $layout, fma, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+avx", not(target = "[x86|x86_64]+avx+avx2+fma")))]
+                crate::vector_backend! { $layout, avx, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+sse3", not(target = "[x86|x86_64]+avx")))]
+                crate::vector_backend! { $layout, sse, $type };
+
+                #[target_cfg(not(any(target = "[x86|x86_64]+avx", target = "[x86|x86_64]+sse3")))]
+                crate::vector_backend! { $layout, generic, $type };
+
+                assert_eq!(output.len(), work.len());
+                assert_eq!(size, output.len());
+                if let Some(input) = input {
+                    assert_eq!(input.len(), size);
+                }
+
+                // Fused multiplies are applied by the final stage, which must have a fixed radix
+                debug_assert!(multiply.is_none() || (size > 1 && generic_radices[0] == 0));
+
+                // Scaling is applied by the final stage.  A transform of size 1 has no stages, but
+                // its scale is 1.
+                let scale = match transform {
+                    Transform::Fft | Transform::UnscaledIfft => None,
+                    Transform::Ifft => Some(1. / (size as $type)),
+                    Transform::SqrtScaledFft | Transform::SqrtScaledIfft => Some(1. / (size as $type).sqrt()),
+                };
 
-                for _ in iteration..*iterations {
-                    let (from, to): (&mut _, &mut _) = if data_in_output {
-                        (output, input)
+                let stage_count = stages.iter().sum::<usize>()
+                    + generic_radices.iter().take_while(|radix| **radix != 0).count();
+                let mut buffers = StageBuffers::new(input.is_some(), stage_count);
+
+                let mut stride = 1;
+                for (radix, iterations) in RADICES.iter().zip(stages) {
+                    let mut iteration = 0;
+
+                    // Use partial loads until the stride is large enough
+                    while stride < width! {} && iteration < *iterations {
+                        let (from, to) = buffers.next(input, output, work);
+                        let (stage_twiddles, rest) = StageTwiddles::split(twiddles, size, *radix, compact);
+                        let (stage_multiply, stage_scale) = if size == *radix {
+                            (multiply, scale)
+                        } else {
+                            (None, None)
+                        };
+                        match radix {
+                            8 => dispatch!($radix_mod::radix_8_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            7 => dispatch!($radix_mod::radix_7_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            5 => dispatch!($radix_mod::radix_5_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            4 => dispatch!($radix_mod::radix_4_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            3 => dispatch!($radix_mod::radix_3_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            2 => dispatch!($radix_mod::radix_2_narrow(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            _ => unimplemented!("unsupported radix"),
+                        }
+                        size /= radix;
+                        stride *= radix;
+                        twiddles = rest;
+                        iteration += 1;
+                    }
+
+                    for _ in iteration..*iterations {
+                        let (from, to) = buffers.next(input, output, work);
+                        let (stage_twiddles, rest) = StageTwiddles::split(twiddles, size, *radix, compact);
+                        let (stage_multiply, stage_scale) = if size == *radix {
+                            (multiply, scale)
+                        } else {
+                            (None, None)
+                        };
+                        match radix {
+                            8 => dispatch!($radix_mod::radix_8_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            7 => dispatch!($radix_mod::radix_7_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            5 => dispatch!($radix_mod::radix_5_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            4 => dispatch!($radix_mod::radix_4_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            3 => dispatch!($radix_mod::radix_3_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            2 => dispatch!($radix_mod::radix_2_wide(from, to, transform.is_forward(), size, stride, stage_twiddles, stage_multiply, stage_scale)),
+                            _ => unimplemented!("unsupported radix"),
+                        }
+                        size /= radix;
+                        stride *= radix;
+                        twiddles = rest;
+                    }
+                }
+                for radix in generic_radices.iter().copied().take_while(|radix| *radix != 0) {
+                    let (from, to) = buffers.next(input, output, work);
+                    let stage_scale = if size == radix { scale } else { None };
+                    if stride < width! {} {
+                        dispatch!($radix_mod::radix_generic_narrow(from, to, radix, transform.is_forward(), size, stride, twiddles, stage_scale));
                     } else {
-                        (input, output)
-                    };
-                    match radix {
-                        8 => dispatch!($radix_mod::radix_8_wide(from, to, transform.is_forward(), size, stride, twiddles)),
-                        4 => dispatch!($radix_mod::radix_4_wide(from, to, transform.is_forward(), size, stride, twiddles)),
-                        3 => dispatch!($radix_mod::radix_3_wide(from, to, transform.is_forward(), size, stride, twiddles)),
-                        2 => dispatch!($radix_mod::radix_2_wide(from, to, transform.is_forward(), size, stride, twiddles)),
-                        _ => unimplemented!("unsupported radix"),
+                        dispatch!($radix_mod::radix_generic_wide(from, to, radix, transform.is_forward(), size, stride, twiddles, stage_scale));
                     }
                     size /= radix;
                     stride *= radix;
-                    twiddles = &twiddles[size * radix ..];
-                    data_in_output = !data_in_output;
+                    twiddles = &twiddles[size * radix + radix..];
                 }
-            }
-            if let Some(scale) = match transform {
-                Transform::Fft | Transform::UnscaledIfft => None,
-                Transform::Ifft => Some(1. / (input.len() as $type)),
-                Transform::SqrtScaledFft | Transform::SqrtScaledIfft => Some(1. / (input.len() as $type).sqrt()),
-            } {
-                if data_in_output {
-                    for (x, y) in output.iter().zip(input.iter_mut()) {
-                        *y = x * scale;
-                    }
-                } else {
-                    for x in input.iter_mut() {
-                        *x *= scale;
+
+                // A transform of size 1 has no stages
+                if stage_count == 0 {
+                    if let Some(input) = input {
+                        make_stage_fns! { @copy $layout, input, output }
                     }
                 }
-            } else {
-                if data_in_output {
-                    input.copy_from_slice(output);
-                }
             }
         }
     };
+    { @copy interleaved, $input:ident, $output:ident } => {
+        $output.copy_from_slice($input);
+    };
+    { @copy split, $input:ident, $output:ident } => {
+        let (input_real, input_imag) = $input.parts();
+        let (output_real, output_imag) = $output.parts_mut();
+        output_real.copy_from_slice(input_real);
+        output_imag.copy_from_slice(input_imag);
+    };
 }
-make_stage_fns! { f32, apply_stages_f32, radix_f32 }
-make_stage_fns! { f64, apply_stages_f64, radix_f64 }
+make_stage_fns! { interleaved, f32, apply_stages_f32, apply_batch_f32, radix_f32 }
+make_stage_fns! { interleaved, f64, apply_stages_f64, apply_batch_f64, radix_f64 }
+make_stage_fns! { split, f32, apply_split_stages_f32, radix_split_f32 }
+make_stage_fns! { split, f64, apply_split_stages_f64, radix_split_f64 }
@@ -0,0 +1,32 @@
+//! Helpers for applying transforms to batches of vectors.
+
+/// Asserts that a batch of `count` vectors of `size` elements, with elements separated by `stride`
+/// and vectors separated by `distance`, fits in a buffer of length `len`.
+pub(crate) fn check_batch(size: usize, len: usize, count: usize, stride: usize, distance: usize) {
+    assert!(stride > 0, "stride must be nonzero");
+    if count > 0 && size > 0 {
+        let last = (count - 1)
+            .checked_mul(distance)
+            .and_then(|x| x.checked_add((size - 1).checked_mul(stride)?));
+        assert!(
+            last.map(|last| last < len).unwrap_or(false),
+            "batch exceeds the input buffer"
+        );
+    }
+}
+
+/// Copies the strided vector starting at `input[0]` into `output`.
+#[inline]
+pub(crate) fn gather<T: Copy>(input: &[T], stride: usize, output: &mut [T]) {
+    for (i, x) in output.iter_mut().enumerate() {
+        *x = input[i * stride];
+    }
+}
+
+/// Copies `input` into the strided vector starting at `output[0]`.
+#[inline]
+pub(crate) fn scatter<T: Copy>(input: &[T], output: &mut [T], stride: usize) {
+    for (i, x) in input.iter().enumerate() {
+        output[i * stride] = *x;
+    }
+}
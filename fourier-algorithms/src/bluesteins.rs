@@ -1,5 +1,9 @@
+#![allow(unused_unsafe)]
+#![allow(unused_macros)]
+
+use crate::batch::{check_batch, gather, scatter};
+use crate::work::allocate_work;
 use crate::{Autosort, Fft, FftFloat, Transform};
-use core::cell::RefCell;
 use core::marker::PhantomData;
 use num_complex::Complex;
 
@@ -14,7 +18,41 @@ fn compute_half_twiddle<T: FftFloat>(index: f64, size: usize) -> Complex<T> {
     )
 }
 
-/// Initialize the "w" twiddles.
+/// Returns the size of the inner FFT used by Bluestein's algorithm for an FFT of the specified
+/// size.
+///
+/// The convolution requires an inner FFT of at least `2 * size - 1`.  Of the sizes `2^a * 3^b`
+/// that are large enough, this chooses the one with the lowest estimated cost `n * (a + 2 * b)`,
+/// since radix-3 stages are slower than the radix-2, 4, and 8 stages.  This is often much smaller
+/// than the next power of two: a size of 1025 uses an inner FFT of 2304 rather than 4096.
+pub fn bluesteins_inner_size(size: usize) -> usize {
+    let min_size = (2 * size).saturating_sub(1);
+    let mut best = (usize::max_value(), 0);
+    let mut power_of_three = 1usize;
+    let mut threes = 0;
+    loop {
+        let mut inner_size = power_of_three;
+        let mut twos = 0;
+        while inner_size < min_size {
+            inner_size = inner_size.checked_mul(2).unwrap();
+            twos += 1;
+        }
+        let cost = inner_size.saturating_mul(twos + 2 * threes);
+        if cost < best.0 {
+            best = (cost, inner_size);
+        }
+        if power_of_three >= min_size {
+            break best.1;
+        }
+        power_of_three = power_of_three.checked_mul(3).unwrap();
+        threes += 1;
+    }
+}
+
+/// Initialize the forward "w" twiddles.
+///
+/// The chirp is symmetric, so its transform is too, and the inverse twiddles are the conjugates of
+/// the forward twiddles.
 fn initialize_w_twiddles<
     T: FftFloat,
     E: Extend<Complex<T>> + AsMut<[Complex<T>]>,
@@ -22,8 +60,7 @@ fn initialize_w_twiddles<
 >(
     size: usize,
     fft: &F,
-    forward_twiddles: &mut E,
-    inverse_twiddles: &mut E,
+    twiddles: &mut E,
 ) {
     for i in 0..fft.size() {
         if let Some(index) = {
@@ -35,64 +72,52 @@ fn initialize_w_twiddles<
                 None
             }
         } {
-            let twiddle = compute_half_twiddle(index, size);
-            forward_twiddles.extend(core::iter::once(twiddle.conj()));
-            inverse_twiddles.extend(core::iter::once(twiddle));
+            twiddles.extend(core::iter::once(compute_half_twiddle(index, size).conj()));
         } else {
-            forward_twiddles.extend(core::iter::once(Complex::default()));
-            inverse_twiddles.extend(core::iter::once(Complex::default()));
+            twiddles.extend(core::iter::once(Complex::default()));
         }
     }
-    fft.fft_in_place(forward_twiddles.as_mut());
-    fft.fft_in_place(inverse_twiddles.as_mut());
+    fft.fft_in_place(twiddles.as_mut());
 }
 
-/// Initialize the "x" twiddles.
-fn initialize_x_twiddles<T: FftFloat, E: Extend<Complex<T>>>(
-    size: usize,
-    forward_twiddles: &mut E,
-    inverse_twiddles: &mut E,
-) {
+/// Initialize the forward "x" twiddles.  The inverse twiddles are their conjugates.
+fn initialize_x_twiddles<T: FftFloat, E: Extend<Complex<T>>>(size: usize, twiddles: &mut E) {
     for i in 0..size {
         let twiddle = compute_half_twiddle(-(i as f64).powi(2), size);
-        forward_twiddles.extend(core::iter::once(twiddle.conj()));
-        inverse_twiddles.extend(core::iter::once(twiddle));
+        twiddles.extend(core::iter::once(twiddle.conj()));
     }
 }
 
 /// Implements Bluestein's algorithm for arbitrary FFT sizes.
+///
+/// Like [`Autosort`], the work buffer is supplied by the caller or allocated for each transform,
+/// so a single `Bluesteins` may be shared between threads.
+///
+/// [`Autosort`]: struct.Autosort.html
 pub struct Bluesteins<T, InnerFft, WTwiddles, XTwiddles, Work> {
     size: usize,
     inner_fft: InnerFft,
-    w_forward: WTwiddles,
-    w_inverse: WTwiddles,
-    x_forward: XTwiddles,
-    x_inverse: XTwiddles,
-    work: RefCell<Work>,
+    w_twiddles: WTwiddles,
+    x_twiddles: XTwiddles,
     real_type: PhantomData<T>,
+    work_type: PhantomData<Work>,
 }
 
 impl<T, InnerFft, WTwiddles, XTwiddles, Work> Bluesteins<T, InnerFft, WTwiddles, XTwiddles, Work> {
-    /// Create a new transform generator from parts.  Twiddles factors and work must be the correct
-    /// size.
+    /// Create a new transform generator from parts.  Twiddles factors must be the correct size.
     pub unsafe fn new_from_parts(
         size: usize,
         inner_fft: InnerFft,
-        w_forward: WTwiddles,
-        w_inverse: WTwiddles,
-        x_forward: XTwiddles,
-        x_inverse: XTwiddles,
-        work: Work,
+        w_twiddles: WTwiddles,
+        x_twiddles: XTwiddles,
     ) -> Self {
         Self {
             size,
             inner_fft,
-            w_forward,
-            w_inverse,
-            x_forward,
-            x_inverse,
-            work: RefCell::new(work),
+            w_twiddles,
+            x_twiddles,
             real_type: PhantomData,
+            work_type: PhantomData,
         }
     }
 }
@@ -102,30 +127,24 @@ impl<
         InnerFft: Fft<Real = T>,
         WTwiddles: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
         XTwiddles: Default + Extend<Complex<T>>,
-        Work: Default + Extend<Complex<T>>,
+        Work,
     > Bluesteins<T, InnerFft, WTwiddles, XTwiddles, Work>
 {
     /// Create a new Bluestein's algorithm generator.
     pub fn new_with_fft<F: Fn(usize) -> InnerFft>(size: usize, inner_fft_maker: F) -> Self {
-        let inner_size = (2 * size - 1).checked_next_power_of_two().unwrap();
+        let inner_size = bluesteins_inner_size(size);
         let inner_fft = inner_fft_maker(inner_size);
-        let mut w_forward = WTwiddles::default();
-        let mut w_inverse = WTwiddles::default();
-        let mut x_forward = XTwiddles::default();
-        let mut x_inverse = XTwiddles::default();
-        initialize_w_twiddles(size, &inner_fft, &mut w_forward, &mut w_inverse);
-        initialize_x_twiddles(size, &mut x_forward, &mut x_inverse);
-        let mut work = Work::default();
-        work.extend(core::iter::repeat(Complex::default()).take(inner_fft.size()));
+        let mut w_twiddles = WTwiddles::default();
+        let mut x_twiddles = XTwiddles::default();
+        initialize_w_twiddles(size, &inner_fft, &mut w_twiddles);
+        initialize_x_twiddles(size, &mut x_twiddles);
         Self {
             size,
             inner_fft,
-            w_forward,
-            w_inverse,
-            x_forward,
-            x_inverse,
-            work: RefCell::new(work),
+            w_twiddles,
+            x_twiddles,
             real_type: PhantomData,
+            work_type: PhantomData,
         }
     }
 }
@@ -135,28 +154,23 @@ impl<
         InnerFft: Fft<Real = T>,
         WTwiddles: AsRef<[Complex<T>]>,
         XTwiddles: AsRef<[Complex<T>]>,
-        Work: AsRef<[Complex<T>]>,
+        Work,
     > Bluesteins<T, InnerFft, WTwiddles, XTwiddles, Work>
 {
-    /// Return the w-twiddle factors.
-    pub fn w_twiddles(&self) -> (&[Complex<T>], &[Complex<T>]) {
-        (self.w_forward.as_ref(), self.w_inverse.as_ref())
+    /// Return the forward w-twiddle factors.  The inverse twiddle factors are their conjugates.
+    pub fn w_twiddles(&self) -> &[Complex<T>] {
+        self.w_twiddles.as_ref()
     }
 
-    /// Return the w-twiddle factors.
-    pub fn x_twiddles(&self) -> (&[Complex<T>], &[Complex<T>]) {
-        (self.x_forward.as_ref(), self.x_inverse.as_ref())
+    /// Return the forward x-twiddle factors.  The inverse twiddle factors are their conjugates.
+    pub fn x_twiddles(&self) -> &[Complex<T>] {
+        self.x_twiddles.as_ref()
     }
 
     /// Return the inner FFT size.
     pub fn inner_fft_size(&self) -> usize {
         self.inner_fft.size()
     }
-
-    /// Return the work buffer size.
-    pub fn work_size(&self) -> usize {
-        self.work.borrow().as_ref().len()
-    }
 }
 
 macro_rules! implement {
@@ -168,7 +182,7 @@ macro_rules! implement {
                 AutosortWork: Default + Extend<Complex<$type>> + AsMut<[Complex<$type>]>,
                 WTwiddles: Default + Extend<Complex<$type>> + AsMut<[Complex<$type>]>,
                 XTwiddles: Default + Extend<Complex<$type>>,
-                Work: Default + Extend<Complex<$type>>,
+                Work,
             > Bluesteins<$type, Autosort<$type, AutosortTwiddles, AutosortWork>, WTwiddles, XTwiddles, Work>
         {
             /// Create a new Bluestein's algorithm generator.
@@ -181,7 +195,7 @@ macro_rules! implement {
                 InnerFft: Fft<Real = $type>,
                 WTwiddles: AsRef<[Complex<$type>]>,
                 XTwiddles: AsRef<[Complex<$type>]>,
-                Work: AsMut<[Complex<$type>]>,
+                Work: Default + Extend<Complex<$type>> + AsMut<[Complex<$type>]>,
             > Fft for Bluesteins<$type, InnerFft, WTwiddles, XTwiddles, Work>
         {
             type Real = $type;
@@ -190,70 +204,299 @@ macro_rules! implement {
                 self.size
             }
 
+            fn scratch_size(&self) -> usize {
+                self.inner_fft.size() + self.inner_fft.scratch_size()
+            }
+
             fn transform_in_place(&self, input: &mut [Complex<$type>], transform: Transform) {
-                let mut work = self.work.borrow_mut();
-                let (x, w) = if transform.is_forward() {
-                    (&self.x_forward, &self.w_forward)
-                } else {
-                    (&self.x_inverse, &self.w_inverse)
-                };
+                let mut work = allocate_work::<$type, Work>(self.scratch_size());
+                self.transform_in_place_with_scratch(input, work.as_mut(), transform);
+            }
+
+            fn transform_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<$type>],
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                let (work, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
+                apply(
+                    None,
+                    input,
+                    work,
+                    inner_scratch,
+                    self.x_twiddles.as_ref(),
+                    self.w_twiddles.as_ref(),
+                    &self.inner_fft,
+                    transform,
+                );
+            }
+
+            fn transform(
+                &self,
+                input: &[Complex<$type>],
+                output: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.scratch_size());
+                self.transform_with_scratch(input, output, work.as_mut(), transform);
+            }
+
+            fn transform_with_scratch(
+                &self,
+                input: &[Complex<$type>],
+                output: &mut [Complex<$type>],
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                let (work, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
                 apply(
+                    Some(input),
+                    output,
+                    work,
+                    inner_scratch,
+                    self.x_twiddles.as_ref(),
+                    self.w_twiddles.as_ref(),
+                    &self.inner_fft,
+                    transform,
+                );
+            }
+
+            fn transform_batch_in_place(
+                &self,
+                input: &mut [Complex<$type>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.batch_scratch_size());
+                self.transform_batch_in_place_with_scratch(
                     input,
+                    count,
+                    stride,
+                    distance,
                     work.as_mut(),
-                    x.as_ref(),
-                    w.as_ref(),
+                    transform,
+                );
+            }
+
+            fn transform_batch_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<$type>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                scratch: &mut [Complex<$type>],
+                transform: Transform,
+            ) {
+                check_batch(self.size, input.len(), count, stride, distance);
+                let (buffer, scratch) = scratch.split_at_mut(self.size);
+                let (work, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
+                apply_batch(
+                    input,
+                    count,
+                    stride,
+                    distance,
+                    buffer,
+                    work,
+                    inner_scratch,
+                    self.x_twiddles.as_ref(),
+                    self.w_twiddles.as_ref(),
                     &self.inner_fft,
                     transform,
                 );
             }
+
+            fn transform_split_in_place(
+                &self,
+                real: &mut [$type],
+                imag: &mut [$type],
+                transform: Transform,
+            ) {
+                let mut work = allocate_work::<$type, Work>(self.split_scratch_size());
+                self.transform_split_in_place_with_scratch(real, imag, work.as_mut(), transform);
+            }
         }
     }
 }
 implement! { f32 }
 implement! { f64 }
 
-#[multiversion::multiversion]
-#[clone(target = "[x86|x86_64]+avx")]
-#[inline]
-fn apply<T: FftFloat, F: Fft<Real = T>>(
-    input: &mut [Complex<T>],
-    work: &mut [Complex<T>],
-    x: &[Complex<T>],
-    w: &[Complex<T>],
-    fft: &F,
-    transform: Transform,
-) {
-    assert_eq!(x.len(), input.len());
-
-    let size = input.len();
-    for (w, (x, i)) in work.iter_mut().zip(x.iter().zip(input.iter())) {
-        *w = x * i;
-    }
-    for w in work[size..].iter_mut() {
-        *w = Complex::default();
-    }
-    fft.fft_in_place(work);
-    for (w, wi) in work.iter_mut().zip(w.iter()) {
-        *w *= wi;
-    }
-    fft.ifft_in_place(work);
-    match transform {
-        Transform::Fft | Transform::UnscaledIfft => {
-            for (i, (w, xi)) in input.iter_mut().zip(work.iter().zip(x.iter())) {
-                *i = w * xi;
+crate::multiversion_avx512! {
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn apply_batch<T: Pointwise, F: Fft<Real = T>>(
+        input: &mut [Complex<T>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        buffer: &mut [Complex<T>],
+        work: &mut [Complex<T>],
+        inner_scratch: &mut [Complex<T>],
+        x: &[Complex<T>],
+        w: &[Complex<T>],
+        fft: &F,
+        transform: Transform,
+    ) {
+        let size = x.len();
+        for i in 0..count {
+            let vector = &mut input[i * distance..];
+            if stride == 1 {
+                dispatch!(apply(
+                    None,
+                    &mut vector[..size],
+                    work,
+                    inner_scratch,
+                    x,
+                    w,
+                    fft,
+                    transform
+                ));
+            } else {
+                gather(vector, stride, buffer);
+                dispatch!(apply(
+                    None,
+                    buffer,
+                    work,
+                    inner_scratch,
+                    x,
+                    w,
+                    fft,
+                    transform
+                ));
+                scatter(buffer, vector, stride);
             }
         }
-        Transform::Ifft => {
-            let scale = T::one() / T::from_usize(size).unwrap();
-            for (i, (w, xi)) in input.iter_mut().zip(work.iter().zip(x.iter())) {
-                *i = w * xi * scale;
+    }
+}
+
+crate::multiversion_avx512! {
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn apply<T: Pointwise, F: Fft<Real = T>>(
+        input: Option<&[Complex<T>]>,
+        output: &mut [Complex<T>],
+        work: &mut [Complex<T>],
+        inner_scratch: &mut [Complex<T>],
+        x: &[Complex<T>],
+        w: &[Complex<T>],
+        fft: &F,
+        transform: Transform,
+    ) {
+        assert_eq!(x.len(), output.len());
+        if let Some(input) = input {
+            assert_eq!(input.len(), output.len());
+        }
+
+        // The twiddles are forward twiddles, so the inverse uses their conjugates.  Out-of-place
+        // transforms load the input directly, rather than copying it to the output first.
+        let forward = transform.is_forward();
+        let size = output.len();
+        T::chirp(work, input.unwrap_or(output), x, forward, T::one());
+        fft.fft_multiply_in_place_with_scratch(work, inner_scratch, w, !forward);
+        fft.transform_in_place_with_scratch(work, inner_scratch, Transform::Ifft);
+        let scale = match transform {
+            Transform::Fft | Transform::UnscaledIfft => T::one(),
+            Transform::Ifft => T::one() / T::from_usize(size).unwrap(),
+            Transform::SqrtScaledFft | Transform::SqrtScaledIfft => {
+                T::one() / T::sqrt(T::from_usize(size).unwrap())
+            }
+        };
+        T::chirp(output, &work[..size], x, forward, scale);
+    }
+}
+
+/// The chirp passes of Bluestein's algorithm, vectorized for each float type.
+trait Pointwise: FftFloat {
+    /// Computes `output[i] = input[i] * twiddles[i] * scale`, with the twiddles conjugated for
+    /// inverse transforms, and zeroes the remainder of `output`.
+    fn chirp(
+        output: &mut [Complex<Self>],
+        input: &[Complex<Self>],
+        twiddles: &[Complex<Self>],
+        forward: bool,
+        scale: Self,
+    );
+}
+
+macro_rules! make_pointwise_fns {
+    {
+        $type:ident, $chirp:ident
+    } => {
+        crate::multiversion_avx512! {
+            #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+            #[clone(target = "[x86|x86_64]+avx")]
+            #[clone(target = "[x86|x86_64]+sse3")]
+            #[inline]
+            fn $chirp(
+                output: &mut [Complex<$type>],
+                input: &[Complex<$type>],
+                twiddles: &[Complex<$type>],
+                forward: bool,
+                scale: $type,
+            ) {
+                #[target_cfg(target = "[x86|x86_64]+avx+avx2+fma+avx512f")]
+                crate::vector_backend! { interleaved, avx512, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+avx+avx2+fma", not(target = "[x86|x86_64]+avx+avx2+fma+avx512f")))]
+                crate::vector_backend! { interleaved, fma, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+avx", not(target = "[x86|x86_64]+avx+avx2+fma")))]
+                crate::vector_backend! { interleaved, avx, $type };
+
+                #[target_cfg(all(target = "[x86|x86_64]+sse3", not(target = "[x86|x86_64]+avx")))]
+                crate::vector_backend! { interleaved, sse, $type };
+
+                #[target_cfg(not(any(target = "[x86|x86_64]+avx", target = "[x86|x86_64]+sse3")))]
+                crate::vector_backend! { interleaved, generic, $type };
+
+                let size = input.len();
+                assert_eq!(twiddles.len(), size);
+                assert!(output.len() >= size);
+
+                // Full vectors, followed by single elements
+                let full = size / width!() * width!();
+                for i in (0..full).step_by(width!()) {
+                    unsafe {
+                        let mut twiddle = load_wide!(twiddles.as_ptr().add(i));
+                        if !forward {
+                            twiddle = conj!(twiddle);
+                        }
+                        let value = mul!(load_wide!(input.as_ptr().add(i)), twiddle);
+                        store_wide!(scale!(value, scale), output.as_mut_ptr().add(i));
+                    }
+                }
+                for i in full..size {
+                    unsafe {
+                        let mut twiddle = load_narrow!(twiddles.as_ptr().add(i));
+                        if !forward {
+                            twiddle = conj!(twiddle);
+                        }
+                        let value = mul!(load_narrow!(input.as_ptr().add(i)), twiddle);
+                        store_narrow!(scale!(value, scale), output.as_mut_ptr().add(i));
+                    }
+                }
+                for value in output[size..].iter_mut() {
+                    *value = Complex::default();
+                }
             }
         }
-        Transform::SqrtScaledFft | Transform::SqrtScaledIfft => {
-            let scale = T::one() / T::sqrt(T::from_usize(size).unwrap());
-            for (i, (w, xi)) in input.iter_mut().zip(work.iter().zip(x.iter())) {
-                *i = w * xi * scale;
+
+        impl Pointwise for $type {
+            fn chirp(
+                output: &mut [Complex<$type>],
+                input: &[Complex<$type>],
+                twiddles: &[Complex<$type>],
+                forward: bool,
+                scale: $type,
+            ) {
+                $chirp(output, input, twiddles, forward, scale)
             }
         }
     }
 }
+make_pointwise_fns! { f32, chirp_f32 }
+make_pointwise_fns! { f64, chirp_f64 }
@@ -1,5 +1,12 @@
+use crate::batch::{check_batch, gather, scatter};
+use crate::float::FftFloat;
 use num_complex::Complex;
 
+#[cfg(all(not(feature = "std"), feature = "alloc"))]
+use alloc::{boxed::Box, sync::Arc, vec};
+#[cfg(feature = "std")]
+use std::sync::Arc;
+
 /// Specifies a type of transform to perform.
 #[derive(Copy, Clone, PartialEq, Eq)]
 pub enum Transform {
@@ -44,9 +51,33 @@ pub trait Fft {
     /// The size of the FFT.
     fn size(&self) -> usize;
 
+    /// The minimum size of the scratch buffer used by `transform_in_place_with_scratch` and
+    /// `transform_with_scratch`.
+    ///
+    /// By default, no scratch is used.
+    fn scratch_size(&self) -> usize {
+        0
+    }
+
     /// Apply an FFT or IFFT in-place.
     fn transform_in_place(&self, input: &mut [Complex<Self::Real>], transform: Transform);
 
+    /// Apply an FFT or IFFT in-place, using a caller-supplied scratch buffer.
+    ///
+    /// The scratch buffer must contain at least `scratch_size()` elements.  Its contents on input
+    /// are ignored and its contents on output are unspecified, so a single buffer may be reused
+    /// for transforms of any size.
+    ///
+    /// By default, the scratch buffer is ignored and this is `transform_in_place`.
+    fn transform_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<Self::Real>],
+        _scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    ) {
+        self.transform_in_place(input, transform);
+    }
+
     /// Apply an FFT or IFFT out-of-place.
     fn transform(
         &self,
@@ -60,6 +91,191 @@ pub trait Fft {
         self.transform_in_place(output, transform);
     }
 
+    /// Apply an FFT or IFFT out-of-place, using a caller-supplied scratch buffer.
+    ///
+    /// The scratch buffer must contain at least `scratch_size()` elements.
+    fn transform_with_scratch(
+        &self,
+        input: &[Complex<Self::Real>],
+        output: &mut [Complex<Self::Real>],
+        scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    ) {
+        assert_eq!(input.len(), self.size());
+        assert_eq!(output.len(), self.size());
+        output.copy_from_slice(input);
+        self.transform_in_place_with_scratch(output, scratch, transform);
+    }
+
+    /// The minimum size of the scratch buffer used by `transform_batch_in_place_with_scratch`.
+    fn batch_scratch_size(&self) -> usize {
+        self.size() + self.scratch_size()
+    }
+
+    /// Apply an FFT or IFFT in-place to a batch of vectors.
+    ///
+    /// Vector `i` of the batch consists of the elements `input[i * distance + j * stride]`, for
+    /// `j` in `0..size()`.
+    ///
+    /// By default, a scratch buffer is allocated for `transform_batch_in_place_with_scratch`.
+    /// Without the `std` or `alloc` features nothing can be allocated, so each vector is
+    /// transformed with `transform_in_place`, and `stride` must be 1.
+    fn transform_batch_in_place(
+        &self,
+        input: &mut [Complex<Self::Real>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        transform: Transform,
+    ) {
+        let size = self.size();
+        check_batch(size, input.len(), count, stride, distance);
+        if count == 0 || size == 0 {
+            return;
+        }
+
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        {
+            // The contents of the scratch buffer are ignored, so fill it with any element
+            let mut scratch = vec![input[0]; self.batch_scratch_size()];
+            self.transform_batch_in_place_with_scratch(
+                input,
+                count,
+                stride,
+                distance,
+                &mut scratch,
+                transform,
+            );
+        }
+
+        #[cfg(not(any(feature = "std", feature = "alloc")))]
+        {
+            assert!(
+                stride == 1,
+                "strided batches require a scratch buffer without the `std` or `alloc` features"
+            );
+            for i in 0..count {
+                self.transform_in_place(&mut input[i * distance..][..size], transform);
+            }
+        }
+    }
+
+    /// Apply an FFT or IFFT in-place to a batch of vectors, using a caller-supplied scratch
+    /// buffer.
+    ///
+    /// The scratch buffer must contain at least `batch_scratch_size()` elements.
+    fn transform_batch_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<Self::Real>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    ) {
+        let size = self.size();
+        check_batch(size, input.len(), count, stride, distance);
+        let (buffer, scratch) = scratch.split_at_mut(size);
+        for i in 0..count {
+            let vector = &mut input[i * distance..];
+            if stride == 1 {
+                self.transform_in_place_with_scratch(&mut vector[..size], scratch, transform);
+            } else {
+                gather(vector, stride, buffer);
+                self.transform_in_place_with_scratch(buffer, scratch, transform);
+                scatter(buffer, vector, stride);
+            }
+        }
+    }
+
+    /// The minimum size of the scratch buffer used by `transform_split_in_place_with_scratch`.
+    fn split_scratch_size(&self) -> usize {
+        self.size() + self.scratch_size()
+    }
+
+    /// Apply an FFT or IFFT in-place to split-complex data, where the real and imaginary parts
+    /// are stored in separate slices.
+    ///
+    /// By default, a scratch buffer is allocated for `transform_split_in_place_with_scratch`.
+    /// Interleaving the data requires a buffer, so without the `std` or `alloc` features this
+    /// panics unless the FFT is empty; use `transform_split_in_place_with_scratch` instead.
+    fn transform_split_in_place(
+        &self,
+        real: &mut [Self::Real],
+        imag: &mut [Self::Real],
+        transform: Transform,
+    ) {
+        let size = self.size();
+        assert_eq!(real.len(), size);
+        assert_eq!(imag.len(), size);
+        if size == 0 {
+            return;
+        }
+
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        {
+            // The contents of the scratch buffer are ignored, so fill it with any element
+            let mut scratch = vec![Complex::new(real[0], imag[0]); self.split_scratch_size()];
+            self.transform_split_in_place_with_scratch(real, imag, &mut scratch, transform);
+        }
+
+        #[cfg(not(any(feature = "std", feature = "alloc")))]
+        {
+            let _ = transform;
+            panic!("split-complex transforms without `std` or `alloc` require a scratch buffer");
+        }
+    }
+
+    /// Apply an FFT or IFFT in-place to split-complex data, using a caller-supplied scratch
+    /// buffer.
+    ///
+    /// The scratch buffer must contain at least `split_scratch_size()` elements.  By default, the
+    /// data is interleaved into the scratch buffer, transformed, and split again.
+    fn transform_split_in_place_with_scratch(
+        &self,
+        real: &mut [Self::Real],
+        imag: &mut [Self::Real],
+        scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    ) {
+        let size = self.size();
+        assert_eq!(real.len(), size);
+        assert_eq!(imag.len(), size);
+        let (buffer, scratch) = scratch.split_at_mut(size);
+        for ((x, re), im) in buffer.iter_mut().zip(real.iter()).zip(imag.iter()) {
+            *x = Complex::new(*re, *im);
+        }
+        self.transform_in_place_with_scratch(buffer, scratch, transform);
+        for ((x, re), im) in buffer.iter().zip(real.iter_mut()).zip(imag.iter_mut()) {
+            *re = x.re;
+            *im = x.im;
+        }
+    }
+
+    /// Apply an FFT in-place and multiply each element of the result by the corresponding
+    /// factor (or its conjugate, if `conjugate` is true), using a caller-supplied scratch buffer.
+    ///
+    /// This is the spectral multiplication of a fast convolution.  By default, the FFT and the
+    /// multiplication are separate passes, but implementations may apply the factors while
+    /// storing the outputs of the final stage, saving a pass over the data.
+    ///
+    /// The scratch buffer must contain at least `scratch_size()` elements.
+    fn fft_multiply_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<Self::Real>],
+        scratch: &mut [Complex<Self::Real>],
+        factors: &[Complex<Self::Real>],
+        conjugate: bool,
+    ) where
+        Self::Real: FftFloat,
+    {
+        assert_eq!(factors.len(), self.size());
+        self.transform_in_place_with_scratch(input, scratch, Transform::Fft);
+        for (x, factor) in input.iter_mut().zip(factors) {
+            *x *= if conjugate { factor.conj() } else { *factor };
+        }
+    }
+
     /// Apply an FFT in-place.
     fn fft_in_place(&self, input: &mut [Complex<Self::Real>]) {
         self.transform_in_place(input, Transform::Fft);
@@ -80,3 +296,192 @@ pub trait Fft {
         self.transform(input, output, Transform::Ifft);
     }
 }
+
+macro_rules! implement_pointer {
+    {
+        $pointer:ident
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        impl<F: Fft + ?Sized> Fft for $pointer<F> {
+            type Real = F::Real;
+
+            fn size(&self) -> usize {
+                (**self).size()
+            }
+
+            fn scratch_size(&self) -> usize {
+                (**self).scratch_size()
+            }
+
+            fn transform_in_place(&self, input: &mut [Complex<Self::Real>], transform: Transform) {
+                (**self).transform_in_place(input, transform)
+            }
+
+            fn transform_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<Self::Real>],
+                scratch: &mut [Complex<Self::Real>],
+                transform: Transform,
+            ) {
+                (**self).transform_in_place_with_scratch(input, scratch, transform)
+            }
+
+            fn transform(
+                &self,
+                input: &[Complex<Self::Real>],
+                output: &mut [Complex<Self::Real>],
+                transform: Transform,
+            ) {
+                (**self).transform(input, output, transform)
+            }
+
+            fn transform_with_scratch(
+                &self,
+                input: &[Complex<Self::Real>],
+                output: &mut [Complex<Self::Real>],
+                scratch: &mut [Complex<Self::Real>],
+                transform: Transform,
+            ) {
+                (**self).transform_with_scratch(input, output, scratch, transform)
+            }
+
+            fn fft_multiply_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<Self::Real>],
+                scratch: &mut [Complex<Self::Real>],
+                factors: &[Complex<Self::Real>],
+                conjugate: bool,
+            ) where
+                Self::Real: FftFloat,
+            {
+                (**self).fft_multiply_in_place_with_scratch(input, scratch, factors, conjugate)
+            }
+
+            fn batch_scratch_size(&self) -> usize {
+                (**self).batch_scratch_size()
+            }
+
+            fn transform_batch_in_place(
+                &self,
+                input: &mut [Complex<Self::Real>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                transform: Transform,
+            ) {
+                (**self).transform_batch_in_place(input, count, stride, distance, transform)
+            }
+
+            fn transform_batch_in_place_with_scratch(
+                &self,
+                input: &mut [Complex<Self::Real>],
+                count: usize,
+                stride: usize,
+                distance: usize,
+                scratch: &mut [Complex<Self::Real>],
+                transform: Transform,
+            ) {
+                (**self).transform_batch_in_place_with_scratch(
+                    input, count, stride, distance, scratch, transform,
+                )
+            }
+
+            fn split_scratch_size(&self) -> usize {
+                (**self).split_scratch_size()
+            }
+
+            fn transform_split_in_place(
+                &self,
+                real: &mut [Self::Real],
+                imag: &mut [Self::Real],
+                transform: Transform,
+            ) {
+                (**self).transform_split_in_place(real, imag, transform)
+            }
+
+            fn transform_split_in_place_with_scratch(
+                &self,
+                real: &mut [Self::Real],
+                imag: &mut [Self::Real],
+                scratch: &mut [Complex<Self::Real>],
+                transform: Transform,
+            ) {
+                (**self).transform_split_in_place_with_scratch(real, imag, scratch, transform)
+            }
+        }
+    }
+}
+implement_pointer! { Box }
+implement_pointer! { Arc }
+
+/// The interface for performing FFTs of real-valued data.
+///
+/// The complex spectrum of a real signal of size `N` is conjugate-symmetric, so only the first
+/// `N / 2 + 1` elements are stored.
+pub trait RealFft {
+    /// The real type used by the FFT.
+    type Real: Copy;
+
+    /// The size of the FFT (the number of real samples).
+    fn size(&self) -> usize;
+
+    /// The number of complex elements in the spectrum, `size() / 2 + 1`.
+    fn complex_size(&self) -> usize {
+        self.size() / 2 + 1
+    }
+
+    /// The minimum size of the scratch buffer used by `forward_with_scratch` and
+    /// `inverse_with_scratch`.
+    fn scratch_size(&self) -> usize;
+
+    /// Apply a forward transform (`Fft` or `SqrtScaledFft`) to real input.
+    fn forward(
+        &self,
+        input: &[Self::Real],
+        output: &mut [Complex<Self::Real>],
+        transform: Transform,
+    );
+
+    /// Apply a forward transform to real input, using a caller-supplied scratch buffer.
+    ///
+    /// The scratch buffer must contain at least `scratch_size()` elements.
+    fn forward_with_scratch(
+        &self,
+        input: &[Self::Real],
+        output: &mut [Complex<Self::Real>],
+        scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    );
+
+    /// Apply an inverse transform (`Ifft`, `UnscaledIfft` or `SqrtScaledIfft`) producing real
+    /// output.
+    ///
+    /// The imaginary parts of the first and (for even sizes) last input elements are ignored.
+    fn inverse(
+        &self,
+        input: &[Complex<Self::Real>],
+        output: &mut [Self::Real],
+        transform: Transform,
+    );
+
+    /// Apply an inverse transform producing real output, using a caller-supplied scratch buffer.
+    ///
+    /// The scratch buffer must contain at least `scratch_size()` elements.
+    fn inverse_with_scratch(
+        &self,
+        input: &[Complex<Self::Real>],
+        output: &mut [Self::Real],
+        scratch: &mut [Complex<Self::Real>],
+        transform: Transform,
+    );
+
+    /// Apply an FFT to real input.
+    fn fft(&self, input: &[Self::Real], output: &mut [Complex<Self::Real>]) {
+        self.forward(input, output, Transform::Fft);
+    }
+
+    /// Apply an IFFT producing real output.
+    fn ifft(&self, input: &[Complex<Self::Real>], output: &mut [Self::Real]) {
+        self.inverse(input, output, Transform::Ifft);
+    }
+}
@@ -0,0 +1,409 @@
+use crate::parallel::{for_each, threads};
+use crate::twiddle::compute_twiddle;
+use crate::work::allocate_work;
+use crate::{is_autosort_size, Fft, FftFloat, Transform};
+use core::marker::PhantomData;
+use num_complex::Complex;
+
+/// The number of vectors transposed at once (also used by multidimensional FFTs).
+///
+/// Each row of a tile is a contiguous run of `TILE` elements, so the tile is gathered and
+/// scattered a few cache lines at a time rather than one element per cache line.
+pub(crate) const TILE: usize = 16;
+
+/// The padding added to the stride of buffered vectors.
+///
+/// Vector sizes are often powers of two, and without padding the rows of a tile would map to the
+/// same cache sets.
+pub(crate) const PAD: usize = 8;
+
+/// The smallest size for which the four-step algorithm is preferred over a single autosort FFT.
+///
+/// Below this size the autosort FFT typically fits in the last level cache, so the additional
+/// transposition passes of the four-step algorithm are not worthwhile.
+pub const FOUR_STEP_MIN_SIZE: usize = 1 << 22;
+
+/// Returns the factors `(N1, N2)` of `size` used by the four-step algorithm, or `None` if `size`
+/// is not an autosort size or has no suitable factorization.
+///
+/// `N1` is the largest divisor of `size` that does not exceed its square root, so both factors are
+/// small enough to be transformed in cache.
+pub fn four_step_factors(size: usize) -> Option<(usize, usize)> {
+    if !is_autosort_size(size) {
+        return None;
+    }
+    let mut first = 1;
+    let mut divisor = 2;
+    while divisor * divisor <= size {
+        if size % divisor == 0 {
+            first = divisor;
+        }
+        divisor += 1;
+    }
+    if first < TILE {
+        None
+    } else {
+        Some((first, size / first))
+    }
+}
+
+/// Implements the four-step algorithm for very large FFT sizes.
+///
+/// The input of size `N = N1 * N2` is viewed as an `N1` by `N2` row-major matrix.  The columns are
+/// gathered in tiles into a work matrix, where they are transformed and multiplied by twiddle
+/// factors.  The rows are then gathered in tiles from the work matrix, transformed, and
+/// transposed back into the input.  Each inner FFT is small enough to remain in cache, so the
+/// whole array passes through memory twice rather than once per radix stage.
+///
+/// The tiles are independent, so with the `parallel` feature they are divided between up to
+/// [`threads`] threads.
+///
+/// Like [`Autosort`], the work buffer is supplied by the caller or allocated for each transform,
+/// so a single `FourStep` may be shared between threads.
+///
+/// [`threads`]: fn.threads.html
+///
+/// [`Autosort`]: struct.Autosort.html
+pub struct FourStep<T, InnerFft, Twiddles, Work> {
+    size: usize,
+    column_fft: InnerFft,
+    row_fft: InnerFft,
+    twiddles: Twiddles,
+    real_type: PhantomData<T>,
+    work_type: PhantomData<Work>,
+}
+
+impl<T, InnerFft, Twiddles, Work> FourStep<T, InnerFft, Twiddles, Work> {
+    /// Create a new transform generator from parts.  Twiddles factors must be the correct size.
+    pub unsafe fn new_from_parts(
+        size: usize,
+        column_fft: InnerFft,
+        row_fft: InnerFft,
+        twiddles: Twiddles,
+    ) -> Self {
+        Self {
+            size,
+            column_fft,
+            row_fft,
+            twiddles,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        }
+    }
+}
+
+impl<T: FftFloat, InnerFft: Fft<Real = T>, Twiddles: Default + Extend<Complex<T>>, Work>
+    FourStep<T, InnerFft, Twiddles, Work>
+{
+    /// Create a new four-step algorithm generator, using `inner_fft_maker` to create the column
+    /// and row FFTs with sizes given by `four_step_factors`.  Returns `None` if the size has no
+    /// suitable factorization.
+    pub fn new_with_fft<F: Fn(usize) -> InnerFft>(size: usize, inner_fft_maker: F) -> Option<Self> {
+        let (columns, rows) = four_step_factors(size)?;
+        let column_fft = inner_fft_maker(columns);
+        let row_fft = inner_fft_maker(rows);
+        assert_eq!(column_fft.size(), columns);
+        assert_eq!(row_fft.size(), rows);
+
+        // Twiddle `n2 * N1 + k1` is applied to output `k1` of the FFT of column `n2`.  Inverse
+        // transforms use the conjugates.
+        let mut twiddles = Twiddles::default();
+        for n2 in 0..rows {
+            for k1 in 0..columns {
+                twiddles.extend(core::iter::once(compute_twiddle(n2 * k1, size, true)));
+            }
+        }
+
+        Some(Self {
+            size,
+            column_fft,
+            row_fft,
+            twiddles,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        })
+    }
+}
+
+impl<T, InnerFft: Fft<Real = T>, Twiddles: AsRef<[Complex<T>]>, Work>
+    FourStep<T, InnerFft, Twiddles, Work>
+{
+    /// Return the forward twiddle factors.  The inverse twiddle factors are their conjugates.
+    pub fn twiddles(&self) -> &[Complex<T>] {
+        self.twiddles.as_ref()
+    }
+
+    /// Return the column and row FFT sizes.
+    pub fn inner_fft_sizes(&self) -> (usize, usize) {
+        (self.column_fft.size(), self.row_fft.size())
+    }
+}
+
+impl<
+        T: FftFloat + Send + Sync,
+        InnerFft: Fft<Real = T> + Sync,
+        Twiddles: AsRef<[Complex<T>]>,
+        Work: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+    > Fft for FourStep<T, InnerFft, Twiddles, Work>
+{
+    type Real = T;
+
+    fn size(&self) -> usize {
+        self.size
+    }
+
+    fn scratch_size(&self) -> usize {
+        matrix_size(&self.column_fft, &self.row_fft)
+            + threads() * thread_scratch_size(&self.column_fft, &self.row_fft)
+    }
+
+    fn transform_in_place(&self, input: &mut [Complex<T>], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.scratch_size());
+        self.transform_in_place_with_scratch(input, work.as_mut(), transform);
+    }
+
+    fn transform_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<T>],
+        scratch: &mut [Complex<T>],
+        transform: Transform,
+    ) {
+        assert_eq!(input.len(), self.size);
+        apply(
+            input,
+            scratch,
+            self.twiddles.as_ref(),
+            &self.column_fft,
+            &self.row_fft,
+            transform,
+        );
+    }
+
+    fn transform_batch_in_place(
+        &self,
+        input: &mut [Complex<T>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        transform: Transform,
+    ) {
+        let mut work = allocate_work::<T, Work>(self.batch_scratch_size());
+        self.transform_batch_in_place_with_scratch(
+            input,
+            count,
+            stride,
+            distance,
+            work.as_mut(),
+            transform,
+        );
+    }
+
+    fn transform_split_in_place(&self, real: &mut [T], imag: &mut [T], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.split_scratch_size());
+        self.transform_split_in_place_with_scratch(real, imag, work.as_mut(), transform);
+    }
+}
+
+/// The size of the work matrix, which holds a padded vector for each column.
+fn matrix_size<F: Fft>(column_fft: &F, row_fft: &F) -> usize {
+    row_fft.size() * (column_fft.size() + PAD)
+}
+
+/// The size of the scratch buffer used by each thread.
+fn thread_scratch_size<F: Fft>(column_fft: &F, row_fft: &F) -> usize {
+    core::cmp::max(
+        column_fft.scratch_size(),
+        TILE * (row_fft.size() + PAD) + row_fft.scratch_size(),
+    )
+}
+
+/// A pointer to the output, shared by threads that write disjoint elements.
+#[derive(Copy, Clone)]
+struct SharedOutput<T>(*mut Complex<T>);
+
+unsafe impl<T: Send> Send for SharedOutput<T> {}
+unsafe impl<T: Send> Sync for SharedOutput<T> {}
+
+fn apply<T: FftFloat + Send + Sync, F: Fft<Real = T> + Sync>(
+    input: &mut [Complex<T>],
+    scratch: &mut [Complex<T>],
+    twiddles: &[Complex<T>],
+    column_fft: &F,
+    row_fft: &F,
+    transform: Transform,
+) {
+    let columns = column_fft.size();
+    let rows = row_fft.size();
+    let inner_transform = if transform.is_forward() {
+        Transform::Fft
+    } else {
+        Transform::UnscaledIfft
+    };
+    let scale = match transform {
+        Transform::Fft | Transform::UnscaledIfft => T::one(),
+        Transform::Ifft => T::one() / T::from_usize(input.len()).unwrap(),
+        Transform::SqrtScaledFft | Transform::SqrtScaledIfft => {
+            T::one() / T::sqrt(T::from_usize(input.len()).unwrap())
+        }
+    };
+
+    let (matrix, scratch) = scratch.split_at_mut(matrix_size(column_fft, row_fft));
+    let thread_scratch = thread_scratch_size(column_fft, row_fft);
+    let threads = core::cmp::max(1, core::cmp::min(threads(), scratch.len() / thread_scratch));
+    let scratch = &mut scratch[..threads * thread_scratch];
+
+    // Each thread transforms a contiguous range of tiles
+    let tiles_per_thread = |vectors: usize| {
+        let tiles = (vectors + TILE - 1) / TILE;
+        TILE * ((tiles + threads - 1) / threads)
+    };
+
+    // Transform the columns into the work matrix
+    {
+        let input = &*input;
+        let vectors = tiles_per_thread(rows);
+        for_each(
+            matrix
+                .chunks_mut(vectors * (columns + PAD))
+                .zip(twiddles.chunks(vectors * columns))
+                .zip(scratch.chunks_exact_mut(thread_scratch))
+                .enumerate(),
+            |(i, ((matrix, twiddles), scratch))| {
+                transform_columns(
+                    input,
+                    i * vectors,
+                    matrix,
+                    twiddles,
+                    scratch,
+                    column_fft,
+                    inner_transform,
+                )
+            },
+        );
+    }
+
+    // Transform the rows of the work matrix back into the input
+    {
+        let matrix = &*matrix;
+        let output = SharedOutput(input.as_mut_ptr());
+        let vectors = tiles_per_thread(columns);
+        let count = (columns + vectors - 1) / vectors;
+        for_each(
+            scratch
+                .chunks_exact_mut(thread_scratch)
+                .take(count)
+                .enumerate(),
+            |(i, scratch)| {
+                let first = i * vectors;
+                let last = core::cmp::min(first + vectors, columns);
+                transform_rows(
+                    matrix,
+                    output,
+                    first..last,
+                    scratch,
+                    column_fft.size(),
+                    row_fft,
+                    inner_transform,
+                    scale,
+                )
+            },
+        );
+    }
+}
+
+crate::multiversion_avx512! {
+    /// Gathers the columns starting at `first_column` into the padded vectors of `matrix`, then
+    /// transforms them and applies the twiddle factors.
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn transform_columns<T: FftFloat, F: Fft<Real = T>>(
+        input: &[Complex<T>],
+        first_column: usize,
+        matrix: &mut [Complex<T>],
+        twiddles: &[Complex<T>],
+        scratch: &mut [Complex<T>],
+        fft: &F,
+        transform: Transform,
+    ) {
+        let columns = fft.size();
+        let rows = input.len() / columns;
+        for (index, (tile, twiddles)) in matrix
+            .chunks_mut(TILE * (columns + PAD))
+            .zip(twiddles.chunks(TILE * columns))
+            .enumerate()
+        {
+            let column = first_column + index * TILE;
+            let width = tile.len() / (columns + PAD);
+
+            for (i, row) in input.chunks_exact(rows).enumerate() {
+                for (j, x) in row[column..column + width].iter().enumerate() {
+                    tile[j * (columns + PAD) + i] = *x;
+                }
+            }
+
+            for (vector, twiddles) in tile
+                .chunks_exact_mut(columns + PAD)
+                .zip(twiddles.chunks_exact(columns))
+            {
+                let vector = &mut vector[..columns];
+                fft.transform_in_place_with_scratch(vector, scratch, transform);
+                if transform.is_forward() {
+                    for (x, twiddle) in vector.iter_mut().zip(twiddles.iter()) {
+                        *x *= twiddle;
+                    }
+                } else {
+                    for (x, twiddle) in vector.iter_mut().zip(twiddles.iter()) {
+                        *x *= twiddle.conj();
+                    }
+                }
+            }
+        }
+    }
+}
+
+crate::multiversion_avx512! {
+    /// Gathers the rows in `range` from the work matrix, transforms them, and transposes them into
+    /// the output, applying the scale.
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn transform_rows<T: FftFloat, F: Fft<Real = T>>(
+        matrix: &[Complex<T>],
+        output: SharedOutput<T>,
+        range: core::ops::Range<usize>,
+        scratch: &mut [Complex<T>],
+        columns: usize,
+        fft: &F,
+        transform: Transform,
+        scale: T,
+    ) {
+        let rows = fft.size();
+        let (buffer, scratch) = scratch.split_at_mut(TILE * (rows + PAD));
+        let mut row = range.start;
+        while row < range.end {
+            let height = core::cmp::min(TILE, range.end - row);
+
+            for (j, vector) in matrix.chunks_exact(columns + PAD).enumerate() {
+                for (i, x) in vector[row..row + height].iter().enumerate() {
+                    buffer[i * (rows + PAD) + j] = *x;
+                }
+            }
+
+            for vector in buffer.chunks_exact_mut(rows + PAD).take(height) {
+                fft.transform_in_place_with_scratch(&mut vector[..rows], scratch, transform);
+            }
+
+            for j in 0..rows {
+                for i in 0..height {
+                    // Each thread writes a disjoint range of columns of the output
+                    unsafe {
+                        *output.0.add(j * columns + row + i) = buffer[i * (rows + PAD) + j] * scale;
+                    }
+                }
+            }
+
+            row += height;
+        }
+    }
+}
@@ -3,17 +3,32 @@
 //! the [`fourier`](../fourier/index.html) crate instead.
 #![cfg_attr(not(feature = "std"), no_std)]
 
+#[cfg(all(not(feature = "std"), feature = "alloc"))]
+extern crate alloc;
+
 mod twiddle;
+mod work;
 
 #[macro_use]
 mod vector;
 
 mod autosort;
+mod batch;
 mod bluesteins;
 mod fft;
 mod float;
+mod four_step;
+mod multidimensional;
+mod parallel;
+mod raders;
+mod real;
 
 pub use autosort::*;
 pub use bluesteins::*;
 pub use fft::*;
 pub use float::*;
+pub use four_step::*;
+pub use multidimensional::*;
+pub use parallel::{set_threads, threads};
+pub use raders::*;
+pub use real::*;
@@ -0,0 +1,164 @@
+use crate::four_step::{PAD, TILE};
+use crate::work::allocate_work;
+use crate::{Fft, FftFloat, Transform};
+use core::marker::PhantomData;
+use num_complex::Complex;
+
+/// Implements multidimensional FFTs with a one-dimensional FFT along each axis.
+///
+/// Data is stored in row-major order: the last axis is contiguous.  The contiguous axis is
+/// transformed in place.  Every other axis is transformed in tiles of columns, which are
+/// transposed into a contiguous work buffer, transformed, and transposed back.
+///
+/// The transform is presented as an [`Fft`] over all `size()` elements, so batches and scratch
+/// buffers work as they do for one-dimensional FFTs.
+///
+/// [`Fft`]: trait.Fft.html
+pub struct MultiDimensional<T, InnerFft, Ffts, Work> {
+    size: usize,
+    ffts: Ffts,
+    real_type: PhantomData<T>,
+    inner_fft_type: PhantomData<InnerFft>,
+    work_type: PhantomData<Work>,
+}
+
+impl<T, InnerFft: Fft<Real = T>, Ffts: AsRef<[InnerFft]>, Work>
+    MultiDimensional<T, InnerFft, Ffts, Work>
+{
+    /// Create a new multidimensional FFT from an FFT for each axis, from outermost to innermost.
+    pub fn new(ffts: Ffts) -> Self {
+        assert!(!ffts.as_ref().is_empty());
+        let size = ffts.as_ref().iter().map(|fft| fft.size()).product();
+        Self {
+            size,
+            ffts,
+            real_type: PhantomData,
+            inner_fft_type: PhantomData,
+            work_type: PhantomData,
+        }
+    }
+
+    /// Return the FFT along each axis.
+    pub fn ffts(&self) -> &[InnerFft] {
+        self.ffts.as_ref()
+    }
+}
+
+impl<
+        T: FftFloat,
+        InnerFft: Fft<Real = T>,
+        Ffts: AsRef<[InnerFft]>,
+        Work: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+    > Fft for MultiDimensional<T, InnerFft, Ffts, Work>
+{
+    type Real = T;
+
+    fn size(&self) -> usize {
+        self.size
+    }
+
+    fn scratch_size(&self) -> usize {
+        let (last, rest) = self.ffts.as_ref().split_last().unwrap();
+        rest.iter()
+            .map(|fft| TILE * (fft.size() + PAD) + fft.scratch_size())
+            .fold(last.scratch_size(), core::cmp::max)
+    }
+
+    fn transform_in_place(&self, input: &mut [Complex<T>], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.scratch_size());
+        self.transform_in_place_with_scratch(input, work.as_mut(), transform);
+    }
+
+    fn transform_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<T>],
+        scratch: &mut [Complex<T>],
+        transform: Transform,
+    ) {
+        assert_eq!(input.len(), self.size);
+        let mut stride = self.size;
+        for fft in self.ffts.as_ref() {
+            stride /= fft.size();
+            if stride == 1 {
+                for row in input.chunks_exact_mut(fft.size()) {
+                    fft.transform_in_place_with_scratch(row, scratch, transform);
+                }
+            } else {
+                apply_axis(input, stride, scratch, fft, transform);
+            }
+        }
+    }
+
+    fn transform_batch_in_place(
+        &self,
+        input: &mut [Complex<T>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        transform: Transform,
+    ) {
+        let mut work = allocate_work::<T, Work>(self.batch_scratch_size());
+        self.transform_batch_in_place_with_scratch(
+            input,
+            count,
+            stride,
+            distance,
+            work.as_mut(),
+            transform,
+        );
+    }
+
+    fn transform_split_in_place(&self, real: &mut [T], imag: &mut [T], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.split_scratch_size());
+        self.transform_split_in_place_with_scratch(real, imag, work.as_mut(), transform);
+    }
+}
+
+crate::multiversion_avx512! {
+    /// Transforms along a non-contiguous axis, where consecutive elements of each vector are
+    /// separated by `stride`.
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn apply_axis<T: FftFloat, F: Fft<Real = T>>(
+        input: &mut [Complex<T>],
+        stride: usize,
+        scratch: &mut [Complex<T>],
+        fft: &F,
+        transform: Transform,
+    ) {
+        // Tiles of columns are transposed into vectors with a padded stride
+        let size = fft.size();
+        let (buffer, inner_scratch) = scratch.split_at_mut(TILE * (size + PAD));
+        for block in input.chunks_exact_mut(size * stride) {
+            let mut column = 0;
+            while column < stride {
+                let width = core::cmp::min(TILE, stride - column);
+
+                // Transpose a tile of columns into contiguous vectors
+                for (i, row) in block.chunks_exact(stride).enumerate() {
+                    for (j, x) in row[column..column + width].iter().enumerate() {
+                        buffer[j * (size + PAD) + i] = *x;
+                    }
+                }
+
+                for vector in buffer.chunks_exact_mut(size + PAD).take(width) {
+                    fft.transform_in_place_with_scratch(
+                        &mut vector[..size],
+                        inner_scratch,
+                        transform,
+                    );
+                }
+
+                // Transpose back
+                for (i, row) in block.chunks_exact_mut(stride).enumerate() {
+                    for (j, x) in row[column..column + width].iter_mut().enumerate() {
+                        *x = buffer[j * (size + PAD) + i];
+                    }
+                }
+
+                column += width;
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+//! Splitting a single transform across threads.
+//!
+//! With the `parallel` feature, independent batches of sub-FFTs within a transform (such as the
+//! column and row FFTs of the four-step algorithm) are spawned onto the global `rayon` thread
+//! pool.  Without it, every transform runs on the calling thread.
+
+#[cfg(feature = "parallel")]
+use core::sync::atomic::{AtomicUsize, Ordering};
+
+#[cfg(feature = "parallel")]
+static THREADS: AtomicUsize = AtomicUsize::new(0);
+
+/// Set the maximum number of threads used by a single transform.
+///
+/// A value of 0 (the default) uses every thread in the global `rayon` thread pool.  Without the
+/// `parallel` feature, transforms are always single-threaded and this has no effect.
+///
+/// The scratch size of some transforms depends on the number of threads, so scratch buffers
+/// should be sized after setting the number of threads.  A transform given a smaller scratch
+/// buffer uses fewer threads.
+pub fn set_threads(threads: usize) {
+    #[cfg(feature = "parallel")]
+    THREADS.store(threads, Ordering::Relaxed);
+    #[cfg(not(feature = "parallel"))]
+    let _ = threads;
+}
+
+/// Returns the maximum number of threads used by a single transform.
+pub fn threads() -> usize {
+    #[cfg(feature = "parallel")]
+    {
+        match THREADS.load(Ordering::Relaxed) {
+            0 => rayon::current_num_threads(),
+            threads => threads,
+        }
+    }
+    #[cfg(not(feature = "parallel"))]
+    {
+        1
+    }
+}
+
+/// Applies `f` to each job, running the jobs concurrently if there is more than one.
+pub(crate) fn for_each<J: Send, I: ExactSizeIterator<Item = J> + Send, F: Fn(J) + Sync>(
+    jobs: I,
+    f: F,
+) {
+    #[cfg(feature = "parallel")]
+    {
+        if jobs.len() > 1 {
+            let f = &f;
+            rayon::scope(|s| {
+                for job in jobs {
+                    s.spawn(move |_| f(job));
+                }
+            });
+            return;
+        }
+    }
+    jobs.for_each(f);
+}
@@ -0,0 +1,293 @@
+use crate::twiddle::compute_twiddle;
+use crate::work::allocate_work;
+use crate::{Fft, FftFloat, Transform};
+use core::marker::PhantomData;
+use num_complex::Complex;
+
+/// Returns true if the size is prime.
+pub fn is_prime(size: usize) -> bool {
+    if size < 2 {
+        return false;
+    }
+    let mut divisor = 2;
+    while divisor * divisor <= size {
+        if size % divisor == 0 {
+            return false;
+        }
+        divisor += 1;
+    }
+    true
+}
+
+/// Computes `base^exponent mod modulus`.
+fn pow_mod(base: usize, mut exponent: usize, modulus: usize) -> usize {
+    let modulus = modulus as u128;
+    let mut base = base as u128 % modulus;
+    let mut result = 1;
+    while exponent > 0 {
+        if exponent % 2 == 1 {
+            result = result * base % modulus;
+        }
+        base = base * base % modulus;
+        exponent /= 2;
+    }
+    result as usize
+}
+
+/// Finds the smallest generator of the multiplicative group of integers modulo a prime.
+fn primitive_root(prime: usize) -> usize {
+    let order = prime - 1;
+    (2..prime)
+        .find(|&candidate| {
+            let mut remaining = order;
+            let mut factor = 2;
+            while remaining > 1 {
+                if factor * factor > remaining {
+                    factor = remaining;
+                }
+                if remaining % factor == 0 {
+                    if pow_mod(candidate, order / factor, prime) == 1 {
+                        return false;
+                    }
+                    while remaining % factor == 0 {
+                        remaining /= factor;
+                    }
+                }
+                factor += 1;
+            }
+            true
+        })
+        .unwrap_or(1)
+}
+
+/// Implements Rader's algorithm for prime FFT sizes.
+///
+/// The input (except the first element) is permuted by powers of a generator `g` of the integers
+/// modulo `size`, which turns the DFT into a cyclic convolution of size `size - 1`.  The
+/// convolution is performed with an inner FFT, which is typically much smaller than the padded
+/// FFT used by [`Bluesteins`].
+///
+/// Like [`Autosort`], the work buffer is supplied by the caller or allocated for each transform,
+/// so a single `Raders` may be shared between threads.
+///
+/// [`Autosort`]: struct.Autosort.html
+/// [`Bluesteins`]: struct.Bluesteins.html
+pub struct Raders<T, InnerFft, Twiddles, Indices, Work> {
+    size: usize,
+    inner_fft: InnerFft,
+    twiddles: Twiddles,
+    input_indices: Indices,
+    output_indices: Indices,
+    real_type: PhantomData<T>,
+    work_type: PhantomData<Work>,
+}
+
+impl<T, InnerFft, Twiddles, Indices, Work> Raders<T, InnerFft, Twiddles, Indices, Work> {
+    /// Create a new transform generator from parts.  Twiddles factors and indices must be the
+    /// correct size.
+    pub unsafe fn new_from_parts(
+        size: usize,
+        inner_fft: InnerFft,
+        twiddles: Twiddles,
+        input_indices: Indices,
+        output_indices: Indices,
+    ) -> Self {
+        Self {
+            size,
+            inner_fft,
+            twiddles,
+            input_indices,
+            output_indices,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        }
+    }
+}
+
+impl<
+        T: FftFloat,
+        InnerFft: Fft<Real = T>,
+        Twiddles: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+        Indices: Default + Extend<usize>,
+        Work,
+    > Raders<T, InnerFft, Twiddles, Indices, Work>
+{
+    /// Create a new Rader's algorithm generator, using `inner_fft_maker` to create a complex FFT
+    /// of size `size - 1`.  Returns `None` if the size is not prime.
+    pub fn new_with_fft<F: Fn(usize) -> InnerFft>(size: usize, inner_fft_maker: F) -> Option<Self> {
+        if !is_prime(size) {
+            return None;
+        }
+        let inner_fft = inner_fft_maker(size - 1);
+        assert_eq!(inner_fft.size(), size - 1);
+
+        let generator = primitive_root(size);
+        let generator_inverse = pow_mod(generator, size - 2, size);
+        let mut input_indices = Indices::default();
+        let mut output_indices = Indices::default();
+        let mut twiddles = Twiddles::default();
+
+        // The inverse FFT of the convolution is unscaled, so the twiddles include the scale
+        let scale = T::one() / T::from_usize(size - 1).unwrap();
+        let (mut input_index, mut output_index) = (1, 1);
+        for _ in 0..size - 1 {
+            input_indices.extend(core::iter::once(input_index));
+            output_indices.extend(core::iter::once(output_index));
+            twiddles.extend(core::iter::once(
+                compute_twiddle::<T>(output_index, size, true) * scale,
+            ));
+            input_index = input_index * generator % size;
+            output_index = output_index * generator_inverse % size;
+        }
+        inner_fft.fft_in_place(twiddles.as_mut());
+
+        Some(Self {
+            size,
+            inner_fft,
+            twiddles,
+            input_indices,
+            output_indices,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        })
+    }
+}
+
+impl<T, InnerFft: Fft<Real = T>, Twiddles: AsRef<[Complex<T>]>, Indices: AsRef<[usize]>, Work>
+    Raders<T, InnerFft, Twiddles, Indices, Work>
+{
+    /// Return the forward twiddle factors.
+    ///
+    /// The inverse twiddle factors are the transform of the conjugate sequence, so inverse twiddle
+    /// `k` is the conjugate of forward twiddle `-k` (modulo the inner FFT size).
+    pub fn twiddles(&self) -> &[Complex<T>] {
+        self.twiddles.as_ref()
+    }
+
+    /// Return the input and output permutations.
+    pub fn indices(&self) -> (&[usize], &[usize]) {
+        (self.input_indices.as_ref(), self.output_indices.as_ref())
+    }
+
+    /// Return the inner FFT size.
+    pub fn inner_fft_size(&self) -> usize {
+        self.inner_fft.size()
+    }
+}
+
+impl<
+        T: FftFloat,
+        InnerFft: Fft<Real = T>,
+        Twiddles: AsRef<[Complex<T>]>,
+        Indices: AsRef<[usize]>,
+        Work: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+    > Fft for Raders<T, InnerFft, Twiddles, Indices, Work>
+{
+    type Real = T;
+
+    fn size(&self) -> usize {
+        self.size
+    }
+
+    fn scratch_size(&self) -> usize {
+        self.inner_fft.size() + self.inner_fft.scratch_size()
+    }
+
+    fn transform_in_place(&self, input: &mut [Complex<T>], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.scratch_size());
+        self.transform_in_place_with_scratch(input, work.as_mut(), transform);
+    }
+
+    fn transform_in_place_with_scratch(
+        &self,
+        input: &mut [Complex<T>],
+        scratch: &mut [Complex<T>],
+        transform: Transform,
+    ) {
+        assert_eq!(input.len(), self.size);
+        let (work, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
+        apply(
+            input,
+            work,
+            inner_scratch,
+            self.twiddles.as_ref(),
+            self.input_indices.as_ref(),
+            self.output_indices.as_ref(),
+            &self.inner_fft,
+            transform,
+        );
+    }
+
+    fn transform_batch_in_place(
+        &self,
+        input: &mut [Complex<T>],
+        count: usize,
+        stride: usize,
+        distance: usize,
+        transform: Transform,
+    ) {
+        let mut work = allocate_work::<T, Work>(self.batch_scratch_size());
+        self.transform_batch_in_place_with_scratch(
+            input,
+            count,
+            stride,
+            distance,
+            work.as_mut(),
+            transform,
+        );
+    }
+
+    fn transform_split_in_place(&self, real: &mut [T], imag: &mut [T], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.split_scratch_size());
+        self.transform_split_in_place_with_scratch(real, imag, work.as_mut(), transform);
+    }
+}
+
+crate::multiversion_avx512! {
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn apply<T: FftFloat, F: Fft<Real = T>>(
+        input: &mut [Complex<T>],
+        work: &mut [Complex<T>],
+        inner_scratch: &mut [Complex<T>],
+        twiddles: &[Complex<T>],
+        input_indices: &[usize],
+        output_indices: &[usize],
+        fft: &F,
+        transform: Transform,
+    ) {
+        let first = input[0];
+        let mut sum = first;
+        for (w, i) in work.iter_mut().zip(input_indices.iter()) {
+            let x = input[*i];
+            sum += x;
+            *w = x;
+        }
+        fft.transform_in_place_with_scratch(work, inner_scratch, Transform::Fft);
+        if transform.is_forward() {
+            for (w, t) in work.iter_mut().zip(twiddles.iter()) {
+                *w *= t;
+            }
+        } else {
+            let (first, rest) = work.split_first_mut().unwrap();
+            *first *= twiddles[0].conj();
+            for (w, t) in rest.iter_mut().zip(twiddles[1..].iter().rev()) {
+                *w *= t.conj();
+            }
+        }
+        fft.transform_in_place_with_scratch(work, inner_scratch, Transform::UnscaledIfft);
+
+        let scale = match transform {
+            Transform::Fft | Transform::UnscaledIfft => T::one(),
+            Transform::Ifft => T::one() / T::from_usize(input.len()).unwrap(),
+            Transform::SqrtScaledFft | Transform::SqrtScaledIfft => {
+                T::one() / T::sqrt(T::from_usize(input.len()).unwrap())
+            }
+        };
+        input[0] = sum * scale;
+        for (w, o) in work.iter().zip(output_indices.iter()) {
+            input[*o] = (first + w) * scale;
+        }
+    }
+}
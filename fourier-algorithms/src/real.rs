@@ -0,0 +1,249 @@
+use crate::twiddle::compute_twiddle;
+use crate::work::allocate_work;
+use crate::{Fft, FftFloat, RealFft, Transform};
+use core::marker::PhantomData;
+use num_complex::Complex;
+
+/// Returns the size of the complex FFT used by a real FFT of the specified size.
+pub fn real_inner_fft_size(size: usize) -> usize {
+    if size % 2 == 0 {
+        size / 2
+    } else {
+        size
+    }
+}
+
+/// Implements real-valued FFTs with a complex FFT.
+///
+/// Even sizes pack pairs of real samples into a half-size complex FFT, followed by a
+/// post-processing pass (or preceded by a pre-processing pass for the inverse) that separates the
+/// spectra of the even and odd samples.  Odd sizes use a full-size complex FFT.
+///
+/// Like [`Autosort`], the work buffer is supplied by the caller or allocated for each transform,
+/// so a single `PackedRealFft` may be shared between threads.
+///
+/// [`Autosort`]: struct.Autosort.html
+pub struct PackedRealFft<T, InnerFft, Twiddles, Work> {
+    size: usize,
+    inner_fft: InnerFft,
+    twiddles: Twiddles,
+    real_type: PhantomData<T>,
+    work_type: PhantomData<Work>,
+}
+
+impl<T, InnerFft, Twiddles, Work> PackedRealFft<T, InnerFft, Twiddles, Work> {
+    /// Create a new transform generator from parts.  Twiddles factors must be the correct size.
+    pub unsafe fn new_from_parts(size: usize, inner_fft: InnerFft, twiddles: Twiddles) -> Self {
+        Self {
+            size,
+            inner_fft,
+            twiddles,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        }
+    }
+}
+
+impl<T: FftFloat, InnerFft: Fft<Real = T>, Twiddles: Default + Extend<Complex<T>>, Work>
+    PackedRealFft<T, InnerFft, Twiddles, Work>
+{
+    /// Create a new real FFT generator, using `inner_fft_maker` to create a complex FFT of size
+    /// `real_inner_fft_size(size)`.
+    pub fn new_with_fft<F: Fn(usize) -> InnerFft>(size: usize, inner_fft_maker: F) -> Self {
+        let inner_fft = inner_fft_maker(real_inner_fft_size(size));
+        assert_eq!(inner_fft.size(), real_inner_fft_size(size));
+        let mut twiddles = Twiddles::default();
+        if size % 2 == 0 {
+            twiddles.extend((0..=size / 4).map(|k| compute_twiddle(k, size, true)));
+        }
+        Self {
+            size,
+            inner_fft,
+            twiddles,
+            real_type: PhantomData,
+            work_type: PhantomData,
+        }
+    }
+}
+
+impl<T, InnerFft: Fft<Real = T>, Twiddles: AsRef<[Complex<T>]>, Work>
+    PackedRealFft<T, InnerFft, Twiddles, Work>
+{
+    /// Return the post-processing twiddle factors.
+    pub fn twiddles(&self) -> &[Complex<T>] {
+        self.twiddles.as_ref()
+    }
+
+    /// Return the inner FFT size.
+    pub fn inner_fft_size(&self) -> usize {
+        self.inner_fft.size()
+    }
+}
+
+impl<
+        T: FftFloat,
+        InnerFft: Fft<Real = T>,
+        Twiddles: AsRef<[Complex<T>]>,
+        Work: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+    > RealFft for PackedRealFft<T, InnerFft, Twiddles, Work>
+{
+    type Real = T;
+
+    fn size(&self) -> usize {
+        self.size
+    }
+
+    fn scratch_size(&self) -> usize {
+        self.inner_fft.size() + self.inner_fft.scratch_size()
+    }
+
+    fn forward(&self, input: &[T], output: &mut [Complex<T>], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.scratch_size());
+        self.forward_with_scratch(input, output, work.as_mut(), transform);
+    }
+
+    fn forward_with_scratch(
+        &self,
+        input: &[T],
+        output: &mut [Complex<T>],
+        scratch: &mut [Complex<T>],
+        transform: Transform,
+    ) {
+        assert!(transform.is_forward());
+        assert_eq!(input.len(), self.size);
+        assert_eq!(output.len(), self.complex_size());
+        let (buffer, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
+        if self.size % 2 == 0 {
+            // The spectrum is computed in the output buffer, which is one element longer
+            let half = self.inner_fft.size();
+            for (o, i) in output[..half].iter_mut().zip(input.chunks_exact(2)) {
+                *o = Complex::new(i[0], i[1]);
+            }
+            self.inner_fft.transform_in_place_with_scratch(
+                &mut output[..half],
+                inner_scratch,
+                Transform::Fft,
+            );
+            let scale = match transform {
+                Transform::SqrtScaledFft => T::one() / T::sqrt(T::from_usize(self.size).unwrap()),
+                _ => T::one(),
+            };
+            forward_post(output, self.twiddles.as_ref(), scale);
+        } else {
+            for (b, i) in buffer.iter_mut().zip(input.iter()) {
+                *b = Complex::new(*i, T::zero());
+            }
+            self.inner_fft
+                .transform_in_place_with_scratch(buffer, inner_scratch, transform);
+            output.copy_from_slice(&buffer[..output.len()]);
+        }
+    }
+
+    fn inverse(&self, input: &[Complex<T>], output: &mut [T], transform: Transform) {
+        let mut work = allocate_work::<T, Work>(self.scratch_size());
+        self.inverse_with_scratch(input, output, work.as_mut(), transform);
+    }
+
+    fn inverse_with_scratch(
+        &self,
+        input: &[Complex<T>],
+        output: &mut [T],
+        scratch: &mut [Complex<T>],
+        transform: Transform,
+    ) {
+        assert!(!transform.is_forward());
+        assert_eq!(input.len(), self.complex_size());
+        assert_eq!(output.len(), self.size);
+        let (buffer, inner_scratch) = scratch.split_at_mut(self.inner_fft.size());
+        if self.size % 2 == 0 {
+            let scale = match transform {
+                Transform::Ifft => T::one() / T::from_usize(self.size).unwrap(),
+                Transform::SqrtScaledIfft => T::one() / T::sqrt(T::from_usize(self.size).unwrap()),
+                _ => T::one(),
+            };
+            inverse_pre(input, buffer, self.twiddles.as_ref(), scale);
+            self.inner_fft.transform_in_place_with_scratch(
+                buffer,
+                inner_scratch,
+                Transform::UnscaledIfft,
+            );
+            for (o, b) in output.chunks_exact_mut(2).zip(buffer.iter()) {
+                o[0] = b.re;
+                o[1] = b.im;
+            }
+        } else {
+            buffer[0] = Complex::new(input[0].re, T::zero());
+            for (k, x) in input.iter().enumerate().skip(1) {
+                buffer[k] = *x;
+                buffer[self.size - k] = x.conj();
+            }
+            self.inner_fft
+                .transform_in_place_with_scratch(buffer, inner_scratch, transform);
+            for (o, b) in output.iter_mut().zip(buffer.iter()) {
+                *o = b.re;
+            }
+        }
+    }
+}
+
+crate::multiversion_avx512! {
+    /// Separates the half-size FFT `Z` (stored in the first `M` elements of `output`) into the
+    /// spectrum `X` of the real signal.
+    ///
+    /// With `E` and `O` the spectra of the even and odd samples,
+    /// `E[k] = (Z[k] + conj(Z[M - k])) / 2`, `O[k] = -i (Z[k] - conj(Z[M - k])) / 2`, and
+    /// `X[k] = E[k] + W^k O[k]`.  Elements `k` and `M - k` depend on the same inputs, so they are
+    /// computed in pairs.
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn forward_post<T: FftFloat>(output: &mut [Complex<T>], twiddles: &[Complex<T>], scale: T) {
+        let m = output.len() - 1;
+        let z0 = output[0];
+        output[0] = Complex::new((z0.re + z0.im) * scale, T::zero());
+        output[m] = Complex::new((z0.re - z0.im) * scale, T::zero());
+        let half = scale / T::from_usize(2).unwrap();
+        for (k, w) in twiddles.iter().enumerate().skip(1) {
+            let j = m - k;
+            let a = output[k];
+            let b = output[j];
+            let e = (a + b.conj()).scale(half);
+            let o = (a - b.conj()).scale(half);
+            let o = Complex::new(o.im, -o.re);
+            output[j] = (e - w * o).conj();
+            output[k] = e + w * o;
+        }
+    }
+}
+
+crate::multiversion_avx512! {
+    /// Combines the spectrum `X` of the real signal into the input `Z` of the half-size inverse
+    /// FFT.
+    ///
+    /// This is the inverse of `forward_post`:
+    /// `Z[k] = (X[k] + conj(X[M - k])) + i W^-k (X[k] - conj(X[M - k]))`.
+    #[clone(target = "[x86|x86_64]+avx+avx2+fma")]
+    #[clone(target = "[x86|x86_64]+avx")]
+    #[inline]
+    fn inverse_pre<T: FftFloat>(
+        input: &[Complex<T>],
+        output: &mut [Complex<T>],
+        twiddles: &[Complex<T>],
+        scale: T,
+    ) {
+        let m = output.len();
+        let x0 = input[0].re;
+        let xm = input[m].re;
+        output[0] = Complex::new(x0 + xm, x0 - xm).scale(scale);
+        for (k, w) in twiddles.iter().enumerate().skip(1) {
+            let j = m - k;
+            let a = input[k];
+            let b = input[j];
+            let p = (a + b.conj()).scale(scale);
+            let q = (a - b.conj()).scale(scale) * w.conj();
+            let iq = Complex::new(-q.im, q.re);
+            output[j] = p.conj() + Complex::new(q.im, q.re);
+            output[k] = p + iq;
+        }
+    }
+}
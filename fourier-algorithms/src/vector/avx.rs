@@ -57,6 +57,10 @@ macro_rules! avx_vector {
             }
         }
 
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm256_mul_ps($z, _mm256_set1_ps($s)) } }
+        }
+
         macro_rules! rotate {
             { $z:expr, $positive:expr } => {
                 unsafe {
@@ -69,6 +73,10 @@ macro_rules! avx_vector {
             }
         }
 
+        macro_rules! conj {
+            { $z:expr } => { unsafe { _mm256_xor_ps($z, _mm256_set_ps(-0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0)) } }
+        }
+
         macro_rules! load_wide {
             { $from:expr } => { _mm256_loadu_ps($from as *const f32) }
         }
@@ -155,6 +163,10 @@ macro_rules! avx_vector {
             }
         }
 
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm256_mul_pd($z, _mm256_set1_pd($s)) } }
+        }
+
         macro_rules! rotate {
             { $z:expr, $positive:expr } => {
                 unsafe {
@@ -167,6 +179,10 @@ macro_rules! avx_vector {
             }
         }
 
+        macro_rules! conj {
+            { $z:expr } => { unsafe { _mm256_xor_pd($z, _mm256_set_pd(-0.0, 0.0, -0.0, 0.0)) } }
+        }
+
         macro_rules! load_wide {
             { $from:expr } => { _mm256_loadu_pd($from as *const f64) }
         }
@@ -181,13 +197,278 @@ macro_rules! avx_vector {
                     _mm256_setzero_pd(),
                     _mm_loadu_pd($from as *const f64),
                     0,
-                );
+                )
+            }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => {
+                _mm_storeu_pd($to as *mut f64, _mm256_extractf128_pd($z, 0))
+            }
+        }
+    };
+    { f32, fma } => {
+        crate::avx_vector! { f32 };
+
+        // Complex multiply with fused multiply-add
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm256_moveldup_ps($a);
+                    let im = _mm256_movehdup_ps($a);
+                    let sh = _mm256_permute_ps($b, 0xb1);
+                    _mm256_fmaddsub_ps(re, $b, _mm256_mul_ps(im, sh))
+                }
+            }
+        }
+    };
+    { f64, fma } => {
+        crate::avx_vector! { f64 };
+
+        // Complex multiply with fused multiply-add
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm256_unpacklo_pd($a, $a);
+                    let im = _mm256_unpackhi_pd($a, $a);
+                    let sh = _mm256_permute_pd($b, 0x5);
+                    _mm256_fmaddsub_pd(re, $b, _mm256_mul_pd(im, sh))
+                }
+            }
+        }
+    }
+}
+
+/// The AVX backend for split-complex data.
+///
+/// Each vector is a pair of registers containing the real and imaginary parts, so complex
+/// multiplication and rotation require no shuffles.
+#[macro_export]
+#[doc(hidden)]
+macro_rules! avx_split_vector {
+    { f32 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 8 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { (_mm256_setzero_ps(), _mm256_setzero_ps()) } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => { { let z = $z; unsafe { (_mm256_set1_ps(z.re), _mm256_set1_ps(z.im)) } } }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => {
+                { let (a, b) = ($a, $b); unsafe { (_mm256_add_ps(a.0, b.0), _mm256_add_ps(a.1, b.1)) } }
+            }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => {
+                { let (a, b) = ($a, $b); unsafe { (_mm256_sub_ps(a.0, b.0), _mm256_sub_ps(a.1, b.1)) } }
+            }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                {
+                    let (a, b) = ($a, $b);
+                    unsafe {
+                        (
+                            _mm256_sub_ps(_mm256_mul_ps(a.0, b.0), _mm256_mul_ps(a.1, b.1)),
+                            _mm256_add_ps(_mm256_mul_ps(a.0, b.1), _mm256_mul_ps(a.1, b.0)),
+                        )
+                    }
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => {
+                {
+                    let z = $z;
+                    unsafe {
+                        let s = _mm256_set1_ps($s);
+                        (_mm256_mul_ps(z.0, s), _mm256_mul_ps(z.1, s))
+                    }
+                }
+            }
+        }
+
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                {
+                    let z = $z;
+                    unsafe {
+                        if $positive {
+                            (_mm256_sub_ps(_mm256_setzero_ps(), z.1), z.0)
+                        } else {
+                            (z.1, _mm256_sub_ps(_mm256_setzero_ps(), z.0))
+                        }
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { { let z = $z; unsafe { (z.0, _mm256_sub_ps(_mm256_setzero_ps(), z.1)) } } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => {
+                { let from = $from; (_mm256_loadu_ps(from.real), _mm256_loadu_ps(from.imag)) }
+            }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => {
+                {
+                    let (z, to) = ($z, $to);
+                    _mm256_storeu_ps(to.real, z.0);
+                    _mm256_storeu_ps(to.imag, z.1);
+                }
+            }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => {
+                { let from = $from; (_mm256_broadcast_ss(&*from.real), _mm256_broadcast_ss(&*from.imag)) }
+            }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => {
+                {
+                    let (z, to) = ($z, $to);
+                    *to.real = _mm256_cvtss_f32(z.0);
+                    *to.imag = _mm256_cvtss_f32(z.1);
+                }
+            }
+        }
+    };
+    { f64 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 4 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { (_mm256_setzero_pd(), _mm256_setzero_pd()) } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => { { let z = $z; unsafe { (_mm256_set1_pd(z.re), _mm256_set1_pd(z.im)) } } }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => {
+                { let (a, b) = ($a, $b); unsafe { (_mm256_add_pd(a.0, b.0), _mm256_add_pd(a.1, b.1)) } }
+            }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => {
+                { let (a, b) = ($a, $b); unsafe { (_mm256_sub_pd(a.0, b.0), _mm256_sub_pd(a.1, b.1)) } }
+            }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                {
+                    let (a, b) = ($a, $b);
+                    unsafe {
+                        (
+                            _mm256_sub_pd(_mm256_mul_pd(a.0, b.0), _mm256_mul_pd(a.1, b.1)),
+                            _mm256_add_pd(_mm256_mul_pd(a.0, b.1), _mm256_mul_pd(a.1, b.0)),
+                        )
+                    }
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => {
+                {
+                    let z = $z;
+                    unsafe {
+                        let s = _mm256_set1_pd($s);
+                        (_mm256_mul_pd(z.0, s), _mm256_mul_pd(z.1, s))
+                    }
+                }
+            }
+        }
+
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                {
+                    let z = $z;
+                    unsafe {
+                        if $positive {
+                            (_mm256_sub_pd(_mm256_setzero_pd(), z.1), z.0)
+                        } else {
+                            (z.1, _mm256_sub_pd(_mm256_setzero_pd(), z.0))
+                        }
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { { let z = $z; unsafe { (z.0, _mm256_sub_pd(_mm256_setzero_pd(), z.1)) } } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => {
+                { let from = $from; (_mm256_loadu_pd(from.real), _mm256_loadu_pd(from.imag)) }
+            }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => {
+                {
+                    let (z, to) = ($z, $to);
+                    _mm256_storeu_pd(to.real, z.0);
+                    _mm256_storeu_pd(to.imag, z.1);
+                }
+            }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => {
+                { let from = $from; (_mm256_broadcast_sd(&*from.real), _mm256_broadcast_sd(&*from.imag)) }
             }
         }
 
         macro_rules! store_narrow {
             { $z:expr, $to:expr } => {
-                _mm_storeu_pd($to as *mut f64, _mm256_extractf128_pd($z, 0));
+                {
+                    let (z, to) = ($z, $to);
+                    *to.real = _mm256_cvtsd_f64(z.0);
+                    *to.imag = _mm256_cvtsd_f64(z.1);
+                }
             }
         }
     }
@@ -0,0 +1,184 @@
+#![allow(unused_macros)]
+
+#[macro_export]
+#[doc(hidden)]
+macro_rules! avx512_vector {
+    { f32 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 8 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { _mm512_setzero_ps() } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => {
+                unsafe {
+                    _mm512_mask_blend_ps(
+                        0xaaaa,
+                        _mm512_set1_ps($z.re),
+                        _mm512_set1_ps($z.im),
+                    )
+                }
+            }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => { unsafe { _mm512_add_ps($a, $b) } }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => { unsafe { _mm512_sub_ps($a, $b) } }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm512_moveldup_ps($a);
+                    let im = _mm512_movehdup_ps($a);
+                    let sh = _mm512_permute_ps($b, 0xb1);
+                    _mm512_fmaddsub_ps(re, $b, _mm512_mul_ps(im, sh))
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm512_mul_ps($z, _mm512_set1_ps($s)) } }
+        }
+
+        // There is no addsub, so negate either the real or imaginary lanes with a mask
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                unsafe {
+                    let sh = _mm512_permute_ps($z, 0xb1);
+                    if $positive {
+                        _mm512_mask_sub_ps(sh, 0x5555, _mm512_setzero_ps(), sh)
+                    } else {
+                        _mm512_mask_sub_ps(sh, 0xaaaa, _mm512_setzero_ps(), sh)
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { { let z = $z; unsafe { _mm512_mask_sub_ps(z, 0xaaaa, _mm512_setzero_ps(), z) } } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => { _mm512_loadu_ps($from as *const f32) }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => { _mm512_storeu_ps($to as *mut f32, $z) }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => { _mm512_maskz_loadu_ps(0b11, $from as *const f32) }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => { _mm512_mask_storeu_ps($to as *mut f32, 0b11, $z) }
+        }
+    };
+    { f64 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 4 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { _mm512_setzero_pd() } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => {
+                unsafe {
+                    _mm512_mask_blend_pd(
+                        0xaa,
+                        _mm512_set1_pd($z.re),
+                        _mm512_set1_pd($z.im),
+                    )
+                }
+            }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => { unsafe { _mm512_add_pd($a, $b) } }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => { unsafe { _mm512_sub_pd($a, $b) } }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm512_movedup_pd($a);
+                    let im = _mm512_permute_pd($a, 0xff);
+                    let sh = _mm512_permute_pd($b, 0x55);
+                    _mm512_fmaddsub_pd(re, $b, _mm512_mul_pd(im, sh))
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm512_mul_pd($z, _mm512_set1_pd($s)) } }
+        }
+
+        // There is no addsub, so negate either the real or imaginary lanes with a mask
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                unsafe {
+                    let sh = _mm512_permute_pd($z, 0x55);
+                    if $positive {
+                        _mm512_mask_sub_pd(sh, 0x55, _mm512_setzero_pd(), sh)
+                    } else {
+                        _mm512_mask_sub_pd(sh, 0xaa, _mm512_setzero_pd(), sh)
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { { let z = $z; unsafe { _mm512_mask_sub_pd(z, 0xaa, _mm512_setzero_pd(), z) } } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => { _mm512_loadu_pd($from as *const f64) }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => { _mm512_storeu_pd($to as *mut f64, $z) }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => { _mm512_maskz_loadu_pd(0b11, $from as *const f64) }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => { _mm512_mask_storeu_pd($to as *mut f64, 0b11, $z) }
+        }
+    }
+}
@@ -31,6 +31,10 @@ macro_rules! generic_vector {
             { $a:expr, $b:expr } => { { $a * $b } }
         }
 
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { { $z.scale($s) } }
+        }
+
         macro_rules! rotate {
             { $z:expr, $positive:expr } => {
                 {
@@ -43,6 +47,10 @@ macro_rules! generic_vector {
             }
         }
 
+        macro_rules! conj {
+            { $z:expr } => { { $z.conj() } }
+        }
+
         macro_rules! load_wide {
             { $from:expr } => { { *$from } }
         }
@@ -60,3 +68,28 @@ macro_rules! generic_vector {
         }
     }
 }
+
+/// The generic backend for split-complex data, which only differs in loads and stores.
+#[macro_export]
+#[doc(hidden)]
+macro_rules! generic_split_vector {
+    { $type:ty } => {
+        crate::generic_vector! { $type };
+
+        macro_rules! load_wide {
+            { $from:expr } => { { let from = $from; Complex::new(*from.real, *from.imag) } }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => { { let (z, to) = ($z, $to); *to.real = z.re; *to.imag = z.im; } }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => { load_wide!($from) }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => { store_wide!($z, $to) }
+        }
+    }
+}
@@ -1,4 +1,65 @@
 #[macro_use]
 mod avx;
+#[cfg(feature = "avx512")]
+#[macro_use]
+mod avx512;
 #[macro_use]
 mod generic;
+#[macro_use]
+mod sse;
+
+pub mod split;
+
+/// Selects the vector backend for a data layout and instruction set.
+///
+/// Split-complex data uses the AVX backend for every instruction set that includes AVX, and the
+/// generic backend otherwise.
+#[macro_export]
+#[doc(hidden)]
+macro_rules! vector_backend {
+    { interleaved, avx512, $type:ident } => { crate::avx512_vector! { $type } };
+    { interleaved, fma, $type:ident } => { crate::avx_vector! { $type, fma } };
+    { interleaved, avx, $type:ident } => { crate::avx_vector! { $type } };
+    { interleaved, sse, $type:ident } => { crate::sse_vector! { $type } };
+    { interleaved, generic, $type:ident } => { crate::generic_vector! { $type } };
+    { split, avx512, $type:ident } => { crate::avx_split_vector! { $type } };
+    { split, fma, $type:ident } => { crate::avx_split_vector! { $type } };
+    { split, avx, $type:ident } => { crate::avx_split_vector! { $type } };
+    { split, sse, $type:ident } => { crate::generic_split_vector! { $type } };
+    { split, generic, $type:ident } => { crate::generic_split_vector! { $type } };
+}
+
+/// Without the `avx512` feature, AVX-512 targets use the AVX2 and FMA backend.
+#[cfg(not(feature = "avx512"))]
+#[macro_export]
+#[doc(hidden)]
+macro_rules! avx512_vector {
+    { $type:ident } => { crate::avx_vector! { $type, fma } };
+}
+
+/// Applies `multiversion` to a function, adding an AVX-512 clone ahead of the function's own
+/// clones when the `avx512` feature is enabled.
+///
+/// AVX-512 intrinsics require a newer compiler than the rest of the crate, so the clone is opt-in.
+#[cfg(feature = "avx512")]
+#[macro_export]
+#[doc(hidden)]
+macro_rules! multiversion_avx512 {
+    { $($item:tt)* } => {
+        #[multiversion::multiversion]
+        #[clone(target = "[x86|x86_64]+avx+avx2+fma+avx512f")]
+        $($item)*
+    }
+}
+
+/// Applies `multiversion` to a function, adding an AVX-512 clone ahead of the function's own
+/// clones when the `avx512` feature is enabled.
+#[cfg(not(feature = "avx512"))]
+#[macro_export]
+#[doc(hidden)]
+macro_rules! multiversion_avx512 {
+    { $($item:tt)* } => {
+        #[multiversion::multiversion]
+        $($item)*
+    }
+}
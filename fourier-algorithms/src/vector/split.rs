@@ -0,0 +1,102 @@
+use num_complex::Complex;
+
+/// Split-complex data, with the real and imaginary parts in separate slices.
+pub struct Split<'a, T> {
+    real: &'a mut [T],
+    imag: &'a mut [T],
+}
+
+impl<'a, T> Split<'a, T> {
+    /// Create split-complex data from real and imaginary parts of the same length.
+    pub fn new(real: &'a mut [T], imag: &'a mut [T]) -> Self {
+        assert_eq!(real.len(), imag.len());
+        Self { real, imag }
+    }
+
+    /// Use the first `size` elements of a complex buffer as split-complex data.
+    pub fn from_complex(buffer: &'a mut [Complex<T>], size: usize) -> Self {
+        assert!(buffer.len() >= size);
+        // Complex is repr(C), so the buffer contains at least `2 * size` reals
+        let reals =
+            unsafe { core::slice::from_raw_parts_mut(buffer.as_mut_ptr() as *mut T, 2 * size) };
+        let (real, imag) = reals.split_at_mut(size);
+        Self { real, imag }
+    }
+
+    /// Return the number of complex elements.
+    pub fn len(&self) -> usize {
+        self.real.len()
+    }
+
+    /// Return the real and imaginary parts.
+    pub fn parts(&self) -> (&[T], &[T]) {
+        (self.real, self.imag)
+    }
+
+    /// Return the mutable real and imaginary parts.
+    pub fn parts_mut(&mut self) -> (&mut [T], &mut [T]) {
+        (self.real, self.imag)
+    }
+
+    /// Return pointers to the start of the real and imaginary parts.
+    pub fn as_ptr(&self) -> SplitPtr<T> {
+        SplitPtr {
+            real: self.real.as_ptr(),
+            imag: self.imag.as_ptr(),
+        }
+    }
+
+    /// Return mutable pointers to the start of the real and imaginary parts.
+    pub fn as_mut_ptr(&mut self) -> SplitMutPtr<T> {
+        SplitMutPtr {
+            real: self.real.as_mut_ptr(),
+            imag: self.imag.as_mut_ptr(),
+        }
+    }
+}
+
+/// A pointer to split-complex data.
+pub struct SplitPtr<T> {
+    pub real: *const T,
+    pub imag: *const T,
+}
+
+impl<T> Clone for SplitPtr<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+impl<T> Copy for SplitPtr<T> {}
+
+impl<T> SplitPtr<T> {
+    /// Offset both pointers by `count` elements.
+    pub unsafe fn add(self, count: usize) -> Self {
+        Self {
+            real: self.real.add(count),
+            imag: self.imag.add(count),
+        }
+    }
+}
+
+/// A mutable pointer to split-complex data.
+pub struct SplitMutPtr<T> {
+    pub real: *mut T,
+    pub imag: *mut T,
+}
+
+impl<T> Clone for SplitMutPtr<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+impl<T> Copy for SplitMutPtr<T> {}
+
+impl<T> SplitMutPtr<T> {
+    /// Offset both pointers by `count` elements.
+    pub unsafe fn add(self, count: usize) -> Self {
+        Self {
+            real: self.real.add(count),
+            imag: self.imag.add(count),
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#![allow(unused_macros)]
+
+#[macro_export]
+#[doc(hidden)]
+macro_rules! sse_vector {
+    { f32 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 2 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { _mm_setzero_ps() } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => { unsafe { _mm_setr_ps($z.re, $z.im, $z.re, $z.im) } }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => { unsafe { _mm_add_ps($a, $b) } }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => { unsafe { _mm_sub_ps($a, $b) } }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm_moveldup_ps($a);
+                    let im = _mm_movehdup_ps($a);
+                    let sh = _mm_shuffle_ps($b, $b, 0xb1);
+                    _mm_addsub_ps(_mm_mul_ps(re, $b), _mm_mul_ps(im, sh))
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm_mul_ps($z, _mm_set1_ps($s)) } }
+        }
+
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                unsafe {
+                    if $positive {
+                        _mm_addsub_ps(_mm_setzero_ps(), _mm_shuffle_ps($z, $z, 0xb1))
+                    } else {
+                        let z = _mm_addsub_ps(_mm_setzero_ps(), $z);
+                        _mm_shuffle_ps(z, z, 0xb1)
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { unsafe { _mm_xor_ps($z, _mm_setr_ps(0.0, -0.0, 0.0, -0.0)) } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => { _mm_loadu_ps($from as *const f32) }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => { _mm_storeu_ps($to as *mut f32, $z) }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => { _mm_castpd_ps(_mm_load_sd($from as *const f64)) }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => { _mm_storel_pd($to as *mut f64, _mm_castps_pd($z)) }
+        }
+    };
+    { f64 } => {
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86")]
+        use core::arch::x86::*;
+
+        #[allow(unused_imports)]
+        #[cfg(target_arch = "x86_64")]
+        use core::arch::x86_64::*;
+
+        #[allow(unused_imports)]
+        use num_complex::Complex;
+
+        macro_rules! width {
+            {} => { 1 }
+        }
+
+        macro_rules! zeroed {
+            {} => { unsafe { _mm_setzero_pd() } }
+        }
+
+        macro_rules! broadcast {
+            { $z:expr } => { unsafe { _mm_setr_pd($z.re, $z.im) } }
+        }
+
+        macro_rules! add {
+            { $a:expr, $b:expr } => { unsafe { _mm_add_pd($a, $b) } }
+        }
+
+        macro_rules! sub {
+            { $a:expr, $b:expr } => { unsafe { _mm_sub_pd($a, $b) } }
+        }
+
+        macro_rules! mul {
+            { $a:expr, $b:expr } => {
+                unsafe {
+                    let re = _mm_movedup_pd($a);
+                    let im = _mm_unpackhi_pd($a, $a);
+                    let sh = _mm_shuffle_pd($b, $b, 0x1);
+                    _mm_addsub_pd(_mm_mul_pd(re, $b), _mm_mul_pd(im, sh))
+                }
+            }
+        }
+
+        macro_rules! scale {
+            { $z:expr, $s:expr } => { unsafe { _mm_mul_pd($z, _mm_set1_pd($s)) } }
+        }
+
+        macro_rules! rotate {
+            { $z:expr, $positive:expr } => {
+                unsafe {
+                    if $positive {
+                        _mm_addsub_pd(_mm_setzero_pd(), _mm_shuffle_pd($z, $z, 0x1))
+                    } else {
+                        let z = _mm_addsub_pd(_mm_setzero_pd(), $z);
+                        _mm_shuffle_pd(z, z, 0x1)
+                    }
+                }
+            }
+        }
+
+        macro_rules! conj {
+            { $z:expr } => { unsafe { _mm_xor_pd($z, _mm_setr_pd(0.0, -0.0)) } }
+        }
+
+        macro_rules! load_wide {
+            { $from:expr } => { _mm_loadu_pd($from as *const f64) }
+        }
+
+        macro_rules! store_wide {
+            { $z:expr, $to:expr } => { _mm_storeu_pd($to as *mut f64, $z) }
+        }
+
+        macro_rules! load_narrow {
+            { $from:expr } => { _mm_loadu_pd($from as *const f64) }
+        }
+
+        macro_rules! store_narrow {
+            { $z:expr, $to:expr } => { _mm_storeu_pd($to as *mut f64, $z) }
+        }
+    }
+}
@@ -0,0 +1,21 @@
+use num_complex::Complex;
+
+/// Allocates a work buffer with at least `size` elements.
+///
+/// Work buffers are allocated for each transform (rather than stored in the transform) so that
+/// transforms may be shared between threads.  The buffer may be longer than requested if
+/// `Work::default()` already contains elements (such as fixed-size arrays or pooled buffers).
+/// `Extend` is only used when `Work::default()` is shorter than `size`, so fixed-size buffers of
+/// at least `size` elements may reject it (as the static FFTs of `fourier-macros` do).
+#[inline]
+pub(crate) fn allocate_work<T: Default + Clone, Work>(size: usize) -> Work
+where
+    Work: Default + Extend<Complex<T>> + AsMut<[Complex<T>]>,
+{
+    let mut work = Work::default();
+    let len = work.as_mut().len();
+    if len < size {
+        work.extend(core::iter::repeat(Complex::default()).take(size - len));
+    }
+    work
+}
@@ -6,6 +6,8 @@
 #include <complex>
 #include <cstddef>
 #include <memory>
+#include <new>
+#include <vector>
 
 #define FOURIER_COMPLEX_FLOAT_TYPE ::std::complex<float>
 #define FOURIER_COMPLEX_DOUBLE_TYPE ::std::complex<double>
@@ -35,15 +37,87 @@ enum {
   FOURIER_TRANSFORM_SQRT_SCALED_IFFT = 4,
 };
 
+/* Planners choose the algorithm used by an FFT.  `MEASURE` times the candidate
+ * algorithms on this machine and keeps the fastest. */
+enum {
+  FOURIER_PLANNER_ESTIMATE = 0,
+  FOURIER_PLANNER_MEASURE = 1,
+};
+
+/* Sets the maximum number of threads used by a single transform, or 0 to use
+ * every available thread.  Has no effect unless the library is built with the
+ * `parallel` feature. */
+void fourier_set_threads(FOURIER_SIZE_TYPE);
+
+/* Wisdom records the algorithms chosen by `FOURIER_PLANNER_MEASURE`, so later
+ * processes can create the same FFTs without measuring.
+ *
+ * `fourier_export_wisdom` returns the size of the wisdom in bytes, and copies
+ * it to `buffer` if it fits in `size` bytes.  `fourier_import_wisdom` returns
+ * 0 on success, or -1 (importing nothing) if the wisdom is malformed.  In both
+ * functions, `buffer` may be null if `size` is 0. */
+FOURIER_SIZE_TYPE fourier_export_wisdom(unsigned char *buffer,
+                                        FOURIER_SIZE_TYPE size);
+int fourier_import_wisdom(const unsigned char *buffer, FOURIER_SIZE_TYPE size);
+void fourier_forget_wisdom(void);
+
+/* Allocates zeroed buffers of `size` complex elements, aligned to cache lines
+ * (or huge pages, for multi-megabyte buffers).  Returns null if the allocation
+ * fails.  Buffers must be freed with the same size. */
+FOURIER_COMPLEX_FLOAT_TYPE *fourier_alloc_complex_float(FOURIER_SIZE_TYPE size);
+FOURIER_COMPLEX_DOUBLE_TYPE *
+fourier_alloc_complex_double(FOURIER_SIZE_TYPE size);
+void fourier_free_complex_float(FOURIER_COMPLEX_FLOAT_TYPE *buffer,
+                                FOURIER_SIZE_TYPE size);
+void fourier_free_complex_double(FOURIER_COMPLEX_DOUBLE_TYPE *buffer,
+                                 FOURIER_SIZE_TYPE size);
+
 struct fourier_fft_float;
 struct fourier_fft_double;
 
 struct fourier_fft_float *fourier_create_float(FOURIER_SIZE_TYPE);
 struct fourier_fft_double *fourier_create_double(FOURIER_SIZE_TYPE);
 
+/* Creates an FFT, choosing the algorithm with a `FOURIER_PLANNER_*` value. */
+struct fourier_fft_float *fourier_create_with_planner_float(FOURIER_SIZE_TYPE,
+                                                            int);
+struct fourier_fft_double *
+fourier_create_with_planner_double(FOURIER_SIZE_TYPE, int);
+
+/* Creates an FFT that stores a fraction of its twiddle factors and computes
+ * the rest as needed, using less memory at some cost in speed. */
+struct fourier_fft_float *fourier_create_compact_float(FOURIER_SIZE_TYPE);
+struct fourier_fft_double *fourier_create_compact_double(FOURIER_SIZE_TYPE);
+
+/* Returns a handle to an FFT shared by every caller in the process.  The first
+ * call for each size creates the FFT, and later calls reuse its tables.  Each
+ * handle must still be destroyed; the FFT is freed when the last handle is
+ * destroyed and the cache is cleared. */
+struct fourier_fft_float *fourier_create_cached_float(FOURIER_SIZE_TYPE);
+struct fourier_fft_double *fourier_create_cached_double(FOURIER_SIZE_TYPE);
+void fourier_clear_fft_cache(void);
+
+/* Multidimensional FFTs of `rank` dimensions operate on row-major arrays (the
+ * last dimension is contiguous), and are used like one-dimensional FFTs over
+ * the product of the dimensions.  Returns null if `dimensions` is null or
+ * `rank` is 0. */
+struct fourier_fft_float *
+fourier_create_multi_float(const FOURIER_SIZE_TYPE *dimensions,
+                           FOURIER_SIZE_TYPE rank);
+struct fourier_fft_double *
+fourier_create_multi_double(const FOURIER_SIZE_TYPE *dimensions,
+                            FOURIER_SIZE_TYPE rank);
+
 void fourier_destroy_float(FOURIER_STRUCT fourier_fft_float *);
 void fourier_destroy_double(FOURIER_STRUCT fourier_fft_double *);
 
+FOURIER_SIZE_TYPE
+fourier_scratch_size_float(const FOURIER_STRUCT fourier_fft_float *);
+FOURIER_SIZE_TYPE
+fourier_scratch_size_double(const FOURIER_STRUCT fourier_fft_double *);
+
+/* Transforms do not modify the FFT, and may be applied concurrently from any
+ * number of threads. */
 void fourier_transform_in_place_float(const FOURIER_STRUCT fourier_fft_float *,
                                       FOURIER_COMPLEX_FLOAT_TYPE *, int);
 void fourier_transform_in_place_double(
@@ -57,10 +131,126 @@ void fourier_transform_double(const FOURIER_STRUCT fourier_fft_double *,
                               const FOURIER_COMPLEX_DOUBLE_TYPE *,
                               FOURIER_COMPLEX_DOUBLE_TYPE *, int);
 
+/* The scratch buffer must contain at least `fourier_scratch_size_*` elements,
+ * and may be shared by FFTs of any size (but not by concurrent transforms).
+ * In every `*_scratch_*` transform, including the batch, split and real ones,
+ * the scratch buffer may be null if the corresponding scratch size is 0. */
+void fourier_transform_in_place_scratch_float(
+    const FOURIER_STRUCT fourier_fft_float *, FOURIER_COMPLEX_FLOAT_TYPE *,
+    FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_in_place_scratch_double(
+    const FOURIER_STRUCT fourier_fft_double *, FOURIER_COMPLEX_DOUBLE_TYPE *,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+void fourier_transform_scratch_float(const FOURIER_STRUCT fourier_fft_float *,
+                                     const FOURIER_COMPLEX_FLOAT_TYPE *,
+                                     FOURIER_COMPLEX_FLOAT_TYPE *,
+                                     FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_scratch_double(const FOURIER_STRUCT fourier_fft_double *,
+                                      const FOURIER_COMPLEX_DOUBLE_TYPE *,
+                                      FOURIER_COMPLEX_DOUBLE_TYPE *,
+                                      FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+/* Batched transforms apply the FFT to `count` vectors.  Element `j` of vector
+ * `i` is located at index `i * distance + j * stride`.  Batches spanning more
+ * elements than can be addressed are ignored. */
+FOURIER_SIZE_TYPE
+fourier_batch_scratch_size_float(const FOURIER_STRUCT fourier_fft_float *);
+FOURIER_SIZE_TYPE
+fourier_batch_scratch_size_double(const FOURIER_STRUCT fourier_fft_double *);
+
+void fourier_transform_batch_in_place_float(
+    const FOURIER_STRUCT fourier_fft_float *, FOURIER_COMPLEX_FLOAT_TYPE *,
+    FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, int);
+void fourier_transform_batch_in_place_double(
+    const FOURIER_STRUCT fourier_fft_double *, FOURIER_COMPLEX_DOUBLE_TYPE *,
+    FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, int);
+
+void fourier_transform_batch_in_place_scratch_float(
+    const FOURIER_STRUCT fourier_fft_float *, FOURIER_COMPLEX_FLOAT_TYPE *,
+    FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE,
+    FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_batch_in_place_scratch_double(
+    const FOURIER_STRUCT fourier_fft_double *, FOURIER_COMPLEX_DOUBLE_TYPE *,
+    FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE, FOURIER_SIZE_TYPE,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+/* Split transforms store the real and imaginary parts in separate arrays of
+ * `size` elements. */
+FOURIER_SIZE_TYPE
+fourier_split_scratch_size_float(const FOURIER_STRUCT fourier_fft_float *);
+FOURIER_SIZE_TYPE
+fourier_split_scratch_size_double(const FOURIER_STRUCT fourier_fft_double *);
+
+void fourier_transform_split_in_place_float(
+    const FOURIER_STRUCT fourier_fft_float *, float *, float *, int);
+void fourier_transform_split_in_place_double(
+    const FOURIER_STRUCT fourier_fft_double *, double *, double *, int);
+
+void fourier_transform_split_in_place_scratch_float(
+    const FOURIER_STRUCT fourier_fft_float *, float *, float *,
+    FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_split_in_place_scratch_double(
+    const FOURIER_STRUCT fourier_fft_double *, double *, double *,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+/* Real FFTs of size `n` transform between `n` real elements and the
+ * `n / 2 + 1` non-redundant elements of the complex spectrum.  Forward
+ * transforms accept `FFT` and `SQRT_SCALED_FFT`, and inverse transforms accept
+ * the IFFT variants. */
+struct fourier_real_fft_float;
+struct fourier_real_fft_double;
+
+struct fourier_real_fft_float *fourier_create_real_float(FOURIER_SIZE_TYPE);
+struct fourier_real_fft_double *fourier_create_real_double(FOURIER_SIZE_TYPE);
+
+void fourier_destroy_real_float(FOURIER_STRUCT fourier_real_fft_float *);
+void fourier_destroy_real_double(FOURIER_STRUCT fourier_real_fft_double *);
+
+FOURIER_SIZE_TYPE
+fourier_real_scratch_size_float(const FOURIER_STRUCT fourier_real_fft_float *);
+FOURIER_SIZE_TYPE
+fourier_real_scratch_size_double(const FOURIER_STRUCT fourier_real_fft_double *);
+
+void fourier_transform_real_forward_float(
+    const FOURIER_STRUCT fourier_real_fft_float *, const float *,
+    FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_real_forward_double(
+    const FOURIER_STRUCT fourier_real_fft_double *, const double *,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+void fourier_transform_real_inverse_float(
+    const FOURIER_STRUCT fourier_real_fft_float *,
+    const FOURIER_COMPLEX_FLOAT_TYPE *, float *, int);
+void fourier_transform_real_inverse_double(
+    const FOURIER_STRUCT fourier_real_fft_double *,
+    const FOURIER_COMPLEX_DOUBLE_TYPE *, double *, int);
+
+void fourier_transform_real_forward_scratch_float(
+    const FOURIER_STRUCT fourier_real_fft_float *, const float *,
+    FOURIER_COMPLEX_FLOAT_TYPE *, FOURIER_COMPLEX_FLOAT_TYPE *, int);
+void fourier_transform_real_forward_scratch_double(
+    const FOURIER_STRUCT fourier_real_fft_double *, const double *,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
+void fourier_transform_real_inverse_scratch_float(
+    const FOURIER_STRUCT fourier_real_fft_float *,
+    const FOURIER_COMPLEX_FLOAT_TYPE *, float *, FOURIER_COMPLEX_FLOAT_TYPE *,
+    int);
+void fourier_transform_real_inverse_scratch_double(
+    const FOURIER_STRUCT fourier_real_fft_double *,
+    const FOURIER_COMPLEX_DOUBLE_TYPE *, double *,
+    FOURIER_COMPLEX_DOUBLE_TYPE *, int);
+
 #ifdef __cplusplus
 } // extern "C"
 } // namespace c
 
+enum class planner {
+  estimate = ::fourier::c::FOURIER_PLANNER_ESTIMATE,
+  measure = ::fourier::c::FOURIER_PLANNER_MEASURE,
+};
+
 enum class transform {
   fft = ::fourier::c::FOURIER_TRANSFORM_FFT,
   ifft = ::fourier::c::FOURIER_TRANSFORM_IFFT,
@@ -69,12 +259,120 @@ enum class transform {
   sqrt_scaled_ifft = ::fourier::c::FOURIER_TRANSFORM_SQRT_SCALED_IFFT,
 };
 
+// Sets the maximum number of threads used by a single transform, or 0 to use
+// every available thread.
+inline void set_threads(::std::size_t threads) {
+  ::fourier::c::fourier_set_threads(threads);
+}
+
+// Returns the algorithms chosen by `planner::measure` in this process.
+inline ::std::vector<unsigned char> export_wisdom() {
+  // Other threads may record wisdom between calls, so retry until it fits
+  ::std::vector<unsigned char> wisdom;
+  for (;;) {
+    auto size =
+        ::fourier::c::fourier_export_wisdom(wisdom.data(), wisdom.size());
+    bool fits = size <= wisdom.size();
+    wisdom.resize(size);
+    if (fits)
+      return wisdom;
+  }
+}
+
+// Imports wisdom exported by `export_wisdom`, returning false if it is
+// malformed.
+inline bool import_wisdom(const ::std::vector<unsigned char> &wisdom) {
+  return ::fourier::c::fourier_import_wisdom(wisdom.data(), wisdom.size()) ==
+         0;
+}
+
+inline void forget_wisdom() { ::fourier::c::fourier_forget_wisdom(); }
+
+inline void clear_fft_cache() { ::fourier::c::fourier_clear_fft_cache(); }
+
+// An allocator of aligned complex buffers, such as
+// `std::vector<std::complex<float>, fourier::allocator<std::complex<float>>>`.
+template <typename T> struct allocator {
+  using value_type = T;
+
+  allocator() = default;
+  template <typename U> allocator(const allocator<U> &) {}
+
+  T *allocate(::std::size_t size);
+  void deallocate(T *buffer, ::std::size_t size);
+};
+
+template <>
+inline ::std::complex<float> *
+allocator<::std::complex<float>>::allocate(::std::size_t size) {
+  auto buffer = ::fourier::c::fourier_alloc_complex_float(size);
+  if (!buffer)
+    throw ::std::bad_alloc();
+  return buffer;
+}
+
+template <>
+inline void
+allocator<::std::complex<float>>::deallocate(::std::complex<float> *buffer,
+                                             ::std::size_t size) {
+  ::fourier::c::fourier_free_complex_float(buffer, size);
+}
+
+template <>
+inline ::std::complex<double> *
+allocator<::std::complex<double>>::allocate(::std::size_t size) {
+  auto buffer = ::fourier::c::fourier_alloc_complex_double(size);
+  if (!buffer)
+    throw ::std::bad_alloc();
+  return buffer;
+}
+
+template <>
+inline void
+allocator<::std::complex<double>>::deallocate(::std::complex<double> *buffer,
+                                              ::std::size_t size) {
+  ::fourier::c::fourier_free_complex_double(buffer, size);
+}
+
+template <typename T, typename U>
+bool operator==(const allocator<T> &, const allocator<U> &) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const allocator<T> &, const allocator<U> &) {
+  return false;
+}
+
+// FFTs are thread-safe: `transform` and `transform_in_place` may be called
+// concurrently on the same object from any number of threads.
 template <typename T> struct fft;
 template <> struct fft<float> {
   explicit fft(std::size_t size)
       : impl(::fourier::c::fourier_create_float(size),
              ::fourier::c::fourier_destroy_float) {}
 
+  fft(std::size_t size, ::fourier::planner p)
+      : impl(::fourier::c::fourier_create_with_planner_float(
+                 size, static_cast<int>(p)),
+             ::fourier::c::fourier_destroy_float) {}
+
+  // Creates a multidimensional FFT over a row-major array.
+  fft(const std::size_t *dimensions, std::size_t rank)
+      : impl(::fourier::c::fourier_create_multi_float(dimensions, rank),
+             ::fourier::c::fourier_destroy_float) {}
+
+  // Creates an FFT with compact twiddle tables, trading speed for memory.
+  static fft compact(std::size_t size) {
+    return fft(::fourier::c::fourier_create_compact_float(size), from_impl{});
+  }
+
+  // Returns an FFT that shares its tables with every other cached FFT of the
+  // same size in the process.
+  static fft cached(std::size_t size) {
+    return fft(::fourier::c::fourier_create_cached_float(size), from_impl{});
+  }
+
   fft() = delete;
   fft(const fft &) = delete;
   fft(fft &&) = default;
@@ -82,6 +380,18 @@ template <> struct fft<float> {
   fft &operator=(fft &&) = default;
   ~fft() = default;
 
+  ::std::size_t scratch_size() const {
+    return ::fourier::c::fourier_scratch_size_float(impl.get());
+  }
+
+  ::std::size_t batch_scratch_size() const {
+    return ::fourier::c::fourier_batch_scratch_size_float(impl.get());
+  }
+
+  ::std::size_t split_scratch_size() const {
+    return ::fourier::c::fourier_split_scratch_size_float(impl.get());
+  }
+
   void transform_in_place(::std::complex<float> *x, transform t) const {
     ::fourier::c::fourier_transform_in_place_float(impl.get(), x,
                                                    static_cast<int>(t));
@@ -93,7 +403,53 @@ template <> struct fft<float> {
                                           static_cast<int>(t));
   }
 
+  void transform_in_place(::std::complex<float> *x,
+                          ::std::complex<float> *scratch,
+                          ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_in_place_scratch_float(
+        impl.get(), x, scratch, static_cast<int>(t));
+  }
+
+  void transform(const ::std::complex<float> *in, ::std::complex<float> *out,
+                 ::std::complex<float> *scratch,
+                 ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_scratch_float(impl.get(), in, out, scratch,
+                                                  static_cast<int>(t));
+  }
+
+  void transform_batch_in_place(::std::complex<float> *x, ::std::size_t count,
+                                ::std::size_t stride, ::std::size_t distance,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_batch_in_place_float(
+        impl.get(), x, count, stride, distance, static_cast<int>(t));
+  }
+
+  void transform_batch_in_place(::std::complex<float> *x, ::std::size_t count,
+                                ::std::size_t stride, ::std::size_t distance,
+                                ::std::complex<float> *scratch,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_batch_in_place_scratch_float(
+        impl.get(), x, count, stride, distance, scratch, static_cast<int>(t));
+  }
+
+  void transform_split_in_place(float *re, float *im,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_split_in_place_float(
+        impl.get(), re, im, static_cast<int>(t));
+  }
+
+  void transform_split_in_place(float *re, float *im,
+                                ::std::complex<float> *scratch,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_split_in_place_scratch_float(
+        impl.get(), re, im, scratch, static_cast<int>(t));
+  }
+
 private:
+  struct from_impl {};
+  fft(::fourier::c::fourier_fft_float *state, from_impl)
+      : impl(state, ::fourier::c::fourier_destroy_float) {}
+
   ::std::unique_ptr<::fourier::c::fourier_fft_float,
                     void (*)(::fourier::c::fourier_fft_float *)>
       impl;
@@ -103,6 +459,27 @@ template <> struct fft<double> {
       : impl(::fourier::c::fourier_create_double(size),
              ::fourier::c::fourier_destroy_double) {}
 
+  fft(std::size_t size, ::fourier::planner p)
+      : impl(::fourier::c::fourier_create_with_planner_double(
+                 size, static_cast<int>(p)),
+             ::fourier::c::fourier_destroy_double) {}
+
+  // Creates a multidimensional FFT over a row-major array.
+  fft(const std::size_t *dimensions, std::size_t rank)
+      : impl(::fourier::c::fourier_create_multi_double(dimensions, rank),
+             ::fourier::c::fourier_destroy_double) {}
+
+  // Creates an FFT with compact twiddle tables, trading speed for memory.
+  static fft compact(std::size_t size) {
+    return fft(::fourier::c::fourier_create_compact_double(size), from_impl{});
+  }
+
+  // Returns an FFT that shares its tables with every other cached FFT of the
+  // same size in the process.
+  static fft cached(std::size_t size) {
+    return fft(::fourier::c::fourier_create_cached_double(size), from_impl{});
+  }
+
   fft() = delete;
   fft(const fft &) = delete;
   fft(fft &&) = default;
@@ -110,6 +487,18 @@ template <> struct fft<double> {
   fft &operator=(fft &&) = default;
   ~fft() = default;
 
+  ::std::size_t scratch_size() const {
+    return ::fourier::c::fourier_scratch_size_double(impl.get());
+  }
+
+  ::std::size_t batch_scratch_size() const {
+    return ::fourier::c::fourier_batch_scratch_size_double(impl.get());
+  }
+
+  ::std::size_t split_scratch_size() const {
+    return ::fourier::c::fourier_split_scratch_size_double(impl.get());
+  }
+
   void transform_in_place(::std::complex<double> *x, transform t) const {
     ::fourier::c::fourier_transform_in_place_double(impl.get(), x,
                                                     static_cast<int>(t));
@@ -121,12 +510,156 @@ template <> struct fft<double> {
                                            static_cast<int>(t));
   }
 
+  void transform_in_place(::std::complex<double> *x,
+                          ::std::complex<double> *scratch,
+                          ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_in_place_scratch_double(
+        impl.get(), x, scratch, static_cast<int>(t));
+  }
+
+  void transform(const ::std::complex<double> *in, ::std::complex<double> *out,
+                 ::std::complex<double> *scratch,
+                 ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_scratch_double(impl.get(), in, out, scratch,
+                                                   static_cast<int>(t));
+  }
+
+  void transform_batch_in_place(::std::complex<double> *x, ::std::size_t count,
+                                ::std::size_t stride, ::std::size_t distance,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_batch_in_place_double(
+        impl.get(), x, count, stride, distance, static_cast<int>(t));
+  }
+
+  void transform_batch_in_place(::std::complex<double> *x, ::std::size_t count,
+                                ::std::size_t stride, ::std::size_t distance,
+                                ::std::complex<double> *scratch,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_batch_in_place_scratch_double(
+        impl.get(), x, count, stride, distance, scratch, static_cast<int>(t));
+  }
+
+  void transform_split_in_place(double *re, double *im,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_split_in_place_double(
+        impl.get(), re, im, static_cast<int>(t));
+  }
+
+  void transform_split_in_place(double *re, double *im,
+                                ::std::complex<double> *scratch,
+                                ::fourier::transform t) const {
+    ::fourier::c::fourier_transform_split_in_place_scratch_double(
+        impl.get(), re, im, scratch, static_cast<int>(t));
+  }
+
 private:
+  struct from_impl {};
+  fft(::fourier::c::fourier_fft_double *state, from_impl)
+      : impl(state, ::fourier::c::fourier_destroy_double) {}
+
   ::std::unique_ptr<::fourier::c::fourier_fft_double,
                     void (*)(::fourier::c::fourier_fft_double *)>
       impl;
 };
 
+// Real FFTs of size `n` transform between `n` real elements and the
+// `n / 2 + 1` non-redundant elements of the complex spectrum.
+template <typename T> struct real_fft;
+template <> struct real_fft<float> {
+  explicit real_fft(std::size_t size)
+      : impl(::fourier::c::fourier_create_real_float(size),
+             ::fourier::c::fourier_destroy_real_float) {}
+
+  real_fft() = delete;
+  real_fft(const real_fft &) = delete;
+  real_fft(real_fft &&) = default;
+  real_fft &operator=(const real_fft &) = delete;
+  real_fft &operator=(real_fft &&) = default;
+  ~real_fft() = default;
+
+  ::std::size_t scratch_size() const {
+    return ::fourier::c::fourier_real_scratch_size_float(impl.get());
+  }
+
+  void forward(const float *in, ::std::complex<float> *out,
+               ::fourier::transform t = ::fourier::transform::fft) const {
+    ::fourier::c::fourier_transform_real_forward_float(impl.get(), in, out,
+                                                    static_cast<int>(t));
+  }
+
+  void inverse(const ::std::complex<float> *in, float *out,
+               ::fourier::transform t = ::fourier::transform::ifft) const {
+    ::fourier::c::fourier_transform_real_inverse_float(impl.get(), in, out,
+                                                    static_cast<int>(t));
+  }
+
+  void forward(const float *in, ::std::complex<float> *out,
+               ::std::complex<float> *scratch,
+               ::fourier::transform t = ::fourier::transform::fft) const {
+    ::fourier::c::fourier_transform_real_forward_scratch_float(
+        impl.get(), in, out, scratch, static_cast<int>(t));
+  }
+
+  void inverse(const ::std::complex<float> *in, float *out,
+               ::std::complex<float> *scratch,
+               ::fourier::transform t = ::fourier::transform::ifft) const {
+    ::fourier::c::fourier_transform_real_inverse_scratch_float(
+        impl.get(), in, out, scratch, static_cast<int>(t));
+  }
+
+private:
+  ::std::unique_ptr<::fourier::c::fourier_real_fft_float,
+                    void (*)(::fourier::c::fourier_real_fft_float *)>
+      impl;
+};
+template <> struct real_fft<double> {
+  explicit real_fft(std::size_t size)
+      : impl(::fourier::c::fourier_create_real_double(size),
+             ::fourier::c::fourier_destroy_real_double) {}
+
+  real_fft() = delete;
+  real_fft(const real_fft &) = delete;
+  real_fft(real_fft &&) = default;
+  real_fft &operator=(const real_fft &) = delete;
+  real_fft &operator=(real_fft &&) = default;
+  ~real_fft() = default;
+
+  ::std::size_t scratch_size() const {
+    return ::fourier::c::fourier_real_scratch_size_double(impl.get());
+  }
+
+  void forward(const double *in, ::std::complex<double> *out,
+               ::fourier::transform t = ::fourier::transform::fft) const {
+    ::fourier::c::fourier_transform_real_forward_double(impl.get(), in, out,
+                                                    static_cast<int>(t));
+  }
+
+  void inverse(const ::std::complex<double> *in, double *out,
+               ::fourier::transform t = ::fourier::transform::ifft) const {
+    ::fourier::c::fourier_transform_real_inverse_double(impl.get(), in, out,
+                                                    static_cast<int>(t));
+  }
+
+  void forward(const double *in, ::std::complex<double> *out,
+               ::std::complex<double> *scratch,
+               ::fourier::transform t = ::fourier::transform::fft) const {
+    ::fourier::c::fourier_transform_real_forward_scratch_double(
+        impl.get(), in, out, scratch, static_cast<int>(t));
+  }
+
+  void inverse(const ::std::complex<double> *in, double *out,
+               ::std::complex<double> *scratch,
+               ::fourier::transform t = ::fourier::transform::ifft) const {
+    ::fourier::c::fourier_transform_real_inverse_scratch_double(
+        impl.get(), in, out, scratch, static_cast<int>(t));
+  }
+
+private:
+  ::std::unique_ptr<::fourier::c::fourier_real_fft_double,
+                    void (*)(::fourier::c::fourier_real_fft_double *)>
+      impl;
+};
+
 } // namespace fourier
 #endif
 
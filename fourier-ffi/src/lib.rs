@@ -11,26 +11,195 @@ fn convert_transform(code: c_int) -> fourier::Transform {
     }
 }
 
+fn convert_planner(code: c_int) -> fourier::Planner {
+    match code {
+        0 => fourier::Planner::Estimate,
+        1 => fourier::Planner::Measure,
+        _ => panic!("unknown planner code"),
+    }
+}
+
+/// Returns the number of elements spanned by a batch.
+///
+/// Panics if the batch is too large to be a valid slice, before any slice is created.
+fn batch_len<T: Copy>(
+    fft: &dyn fourier::Fft<Real = T>,
+    count: usize,
+    stride: usize,
+    distance: usize,
+) -> usize {
+    if count == 0 || fft.size() == 0 {
+        0
+    } else {
+        let max = isize::max_value() as usize / std::mem::size_of::<num_complex::Complex<T>>();
+        (count - 1)
+            .checked_mul(distance)
+            .and_then(|x| x.checked_add((fft.size() - 1).checked_mul(stride)?))
+            .and_then(|x| x.checked_add(1))
+            .filter(|len| *len <= max)
+            .expect("batch too large")
+    }
+}
+
+/// Returns the scratch buffer as a slice.  The buffer may be null when it's empty.
+unsafe fn scratch_slice<'a, T>(scratch: *mut T, len: usize) -> &'a mut [T] {
+    if len == 0 {
+        &mut []
+    } else {
+        std::slice::from_raw_parts_mut(scratch, len)
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_set_threads(threads: size_t) {
+    fourier::set_threads(threads);
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_alloc_complex_float(size: size_t) -> *mut num_complex::Complex<f32> {
+    fourier::AlignedVec::try_zeroed(size)
+        .map_or(std::ptr::null_mut(), |buffer| buffer.into_raw_parts().0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_free_complex_float(
+    buffer: *mut num_complex::Complex<f32>,
+    size: size_t,
+) {
+    // The capacity is rounded up from the size when allocating, and rounds up identically here
+    if !buffer.is_null() {
+        drop(fourier::AlignedVec::from_raw_parts(buffer, 0, size));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_alloc_complex_double(size: size_t) -> *mut num_complex::Complex<f64> {
+    fourier::AlignedVec::try_zeroed(size)
+        .map_or(std::ptr::null_mut(), |buffer| buffer.into_raw_parts().0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_free_complex_double(
+    buffer: *mut num_complex::Complex<f64>,
+    size: size_t,
+) {
+    // The capacity is rounded up from the size when allocating, and rounds up identically here
+    if !buffer.is_null() {
+        drop(fourier::AlignedVec::from_raw_parts(buffer, 0, size));
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_export_wisdom(buffer: *mut u8, size: size_t) -> size_t {
+    let wisdom = fourier::export_wisdom();
+    // The buffer may be null when it's empty, so only create a slice if there's something to copy
+    if !wisdom.is_empty() && wisdom.len() <= size {
+        std::slice::from_raw_parts_mut(buffer, wisdom.len()).copy_from_slice(&wisdom);
+    }
+    wisdom.len()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_import_wisdom(buffer: *const u8, size: size_t) -> c_int {
+    // The buffer may be null when it's empty
+    let wisdom = if size == 0 {
+        &[]
+    } else {
+        std::slice::from_raw_parts(buffer, size)
+    };
+    match fourier::import_wisdom(wisdom) {
+        Ok(()) => 0,
+        Err(_) => -1,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_forget_wisdom() {
+    fourier::forget_wisdom();
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_clear_fft_cache() {
+    fourier::clear_fft_cache();
+}
+
 #[no_mangle]
 pub extern "C" fn fourier_create_float(
     size: usize,
-) -> *const Box<dyn fourier::Fft<Real = f32> + Send> {
+) -> *const Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
     std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_fft_f32(size))))
         .unwrap_or(std::ptr::null_mut())
 }
 
+#[no_mangle]
+pub extern "C" fn fourier_create_with_planner_float(
+    size: usize,
+    planner: c_int,
+) -> *const Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
+    std::panic::catch_unwind(|| {
+        Box::into_raw(Box::new(fourier::create_fft_f32_with_planner(
+            size,
+            convert_planner(planner),
+        )))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_compact_float(
+    size: usize,
+) -> *const Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
+    std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_compact_fft_f32(size))))
+        .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_cached_float(
+    size: usize,
+) -> *const Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
+    std::panic::catch_unwind(|| {
+        let fft: Box<dyn fourier::Fft<Real = f32> + Send + Sync> =
+            Box::new(fourier::cached_fft_f32(size));
+        Box::into_raw(Box::new(fft))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_create_multi_float(
+    dimensions: *const size_t,
+    rank: size_t,
+) -> *const Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
+    if dimensions.is_null() || rank == 0 {
+        return std::ptr::null();
+    }
+    std::panic::catch_unwind(|| {
+        Box::into_raw(Box::new(fourier::create_multi_fft_f32(
+            std::slice::from_raw_parts(dimensions, rank),
+        )))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn fourier_destroy_float(
-    state: *mut Box<dyn fourier::Fft<Real = f32> + Send>,
+    state: *mut Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
 ) {
     let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
         Box::from_raw(state);
     }));
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn fourier_scratch_size_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| (*state).scratch_size())).unwrap_or(0)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn fourier_transform_in_place_float(
-    state: *const Box<dyn fourier::Fft<Real = f32> + Send>,
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
     input: *mut num_complex::Complex<f32>,
     transform: c_int,
 ) {
@@ -44,7 +213,7 @@ pub unsafe extern "C" fn fourier_transform_in_place_float(
 
 #[no_mangle]
 pub unsafe extern "C" fn fourier_transform_float(
-    state: *const Box<dyn fourier::Fft<Real = f32> + Send>,
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
     input: *const num_complex::Complex<f32>,
     output: *mut num_complex::Complex<f32>,
     transform: c_int,
@@ -58,26 +227,213 @@ pub unsafe extern "C" fn fourier_transform_float(
     }));
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_in_place_scratch_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    input: *mut num_complex::Complex<f32>,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(input, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_scratch_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    input: *const num_complex::Complex<f32>,
+    output: *mut num_complex::Complex<f32>,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_with_scratch(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_batch_scratch_size_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).batch_scratch_size()
+    }))
+    .unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_batch_in_place_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    input: *mut num_complex::Complex<f32>,
+    count: size_t,
+    stride: size_t,
+    distance: size_t,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_batch_in_place(
+            std::slice::from_raw_parts_mut(input, batch_len(&**state, count, stride, distance)),
+            count,
+            stride,
+            distance,
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_batch_in_place_scratch_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    input: *mut num_complex::Complex<f32>,
+    count: size_t,
+    stride: size_t,
+    distance: size_t,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_batch_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(input, batch_len(&**state, count, stride, distance)),
+            count,
+            stride,
+            distance,
+            scratch_slice(scratch, (*state).batch_scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_split_scratch_size_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).split_scratch_size()
+    }))
+    .unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_split_in_place_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    real: *mut f32,
+    imag: *mut f32,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_split_in_place(
+            std::slice::from_raw_parts_mut(real, (*state).size()),
+            std::slice::from_raw_parts_mut(imag, (*state).size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_split_in_place_scratch_float(
+    state: *const Box<dyn fourier::Fft<Real = f32> + Send + Sync>,
+    real: *mut f32,
+    imag: *mut f32,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_split_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(real, (*state).size()),
+            std::slice::from_raw_parts_mut(imag, (*state).size()),
+            scratch_slice(scratch, (*state).split_scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
 #[no_mangle]
 pub extern "C" fn fourier_create_double(
     size: size_t,
-) -> *const Box<dyn fourier::Fft<Real = f64> + Send> {
+) -> *const Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
     std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_fft_f64(size))))
         .unwrap_or(std::ptr::null_mut())
 }
 
+#[no_mangle]
+pub extern "C" fn fourier_create_with_planner_double(
+    size: usize,
+    planner: c_int,
+) -> *const Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
+    std::panic::catch_unwind(|| {
+        Box::into_raw(Box::new(fourier::create_fft_f64_with_planner(
+            size,
+            convert_planner(planner),
+        )))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_compact_double(
+    size: usize,
+) -> *const Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
+    std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_compact_fft_f64(size))))
+        .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_cached_double(
+    size: usize,
+) -> *const Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
+    std::panic::catch_unwind(|| {
+        let fft: Box<dyn fourier::Fft<Real = f64> + Send + Sync> =
+            Box::new(fourier::cached_fft_f64(size));
+        Box::into_raw(Box::new(fft))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_create_multi_double(
+    dimensions: *const size_t,
+    rank: size_t,
+) -> *const Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
+    if dimensions.is_null() || rank == 0 {
+        return std::ptr::null();
+    }
+    std::panic::catch_unwind(|| {
+        Box::into_raw(Box::new(fourier::create_multi_fft_f64(
+            std::slice::from_raw_parts(dimensions, rank),
+        )))
+    })
+    .unwrap_or(std::ptr::null_mut())
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn fourier_destroy_double(
-    state: *mut Box<dyn fourier::Fft<Real = f64> + Send>,
+    state: *mut Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
 ) {
     let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
         Box::from_raw(state);
     }));
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn fourier_scratch_size_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| (*state).scratch_size())).unwrap_or(0)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn fourier_transform_in_place_double(
-    state: *const Box<dyn fourier::Fft<Real = f64> + Send>,
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
     input: *mut num_complex::Complex<f64>,
     transform: c_int,
 ) {
@@ -91,7 +447,7 @@ pub unsafe extern "C" fn fourier_transform_in_place_double(
 
 #[no_mangle]
 pub unsafe extern "C" fn fourier_transform_double(
-    state: *const Box<dyn fourier::Fft<Real = f64> + Send>,
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
     input: *const num_complex::Complex<f64>,
     output: *mut num_complex::Complex<f64>,
     transform: c_int,
@@ -104,3 +460,317 @@ pub unsafe extern "C" fn fourier_transform_double(
         );
     }));
 }
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_in_place_scratch_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    input: *mut num_complex::Complex<f64>,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(input, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_scratch_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    input: *const num_complex::Complex<f64>,
+    output: *mut num_complex::Complex<f64>,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_with_scratch(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_batch_scratch_size_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).batch_scratch_size()
+    }))
+    .unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_batch_in_place_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    input: *mut num_complex::Complex<f64>,
+    count: size_t,
+    stride: size_t,
+    distance: size_t,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_batch_in_place(
+            std::slice::from_raw_parts_mut(input, batch_len(&**state, count, stride, distance)),
+            count,
+            stride,
+            distance,
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_batch_in_place_scratch_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    input: *mut num_complex::Complex<f64>,
+    count: size_t,
+    stride: size_t,
+    distance: size_t,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_batch_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(input, batch_len(&**state, count, stride, distance)),
+            count,
+            stride,
+            distance,
+            scratch_slice(scratch, (*state).batch_scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_split_scratch_size_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).split_scratch_size()
+    }))
+    .unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_split_in_place_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    real: *mut f64,
+    imag: *mut f64,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_split_in_place(
+            std::slice::from_raw_parts_mut(real, (*state).size()),
+            std::slice::from_raw_parts_mut(imag, (*state).size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_split_in_place_scratch_double(
+    state: *const Box<dyn fourier::Fft<Real = f64> + Send + Sync>,
+    real: *mut f64,
+    imag: *mut f64,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).transform_split_in_place_with_scratch(
+            std::slice::from_raw_parts_mut(real, (*state).size()),
+            std::slice::from_raw_parts_mut(imag, (*state).size()),
+            scratch_slice(scratch, (*state).split_scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_real_float(
+    size: size_t,
+) -> *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync> {
+    std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_real_fft_f32(size))))
+        .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_destroy_real_float(
+    state: *mut Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        Box::from_raw(state);
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_real_scratch_size_float(
+    state: *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| (*state).scratch_size())).unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_forward_float(
+    state: *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+    input: *const f32,
+    output: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).forward(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).complex_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_inverse_float(
+    state: *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+    input: *const num_complex::Complex<f32>,
+    output: *mut f32,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).inverse(
+            std::slice::from_raw_parts(input, (*state).complex_size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_forward_scratch_float(
+    state: *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+    input: *const f32,
+    output: *mut num_complex::Complex<f32>,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).forward_with_scratch(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).complex_size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_inverse_scratch_float(
+    state: *const Box<dyn fourier::RealFft<Real = f32> + Send + Sync>,
+    input: *const num_complex::Complex<f32>,
+    output: *mut f32,
+    scratch: *mut num_complex::Complex<f32>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).inverse_with_scratch(
+            std::slice::from_raw_parts(input, (*state).complex_size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub extern "C" fn fourier_create_real_double(
+    size: size_t,
+) -> *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync> {
+    std::panic::catch_unwind(|| Box::into_raw(Box::new(fourier::create_real_fft_f64(size))))
+        .unwrap_or(std::ptr::null_mut())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_destroy_real_double(
+    state: *mut Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        Box::from_raw(state);
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_real_scratch_size_double(
+    state: *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+) -> size_t {
+    std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| (*state).scratch_size())).unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_forward_double(
+    state: *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+    input: *const f64,
+    output: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).forward(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).complex_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_inverse_double(
+    state: *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+    input: *const num_complex::Complex<f64>,
+    output: *mut f64,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).inverse(
+            std::slice::from_raw_parts(input, (*state).complex_size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_forward_scratch_double(
+    state: *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+    input: *const f64,
+    output: *mut num_complex::Complex<f64>,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).forward_with_scratch(
+            std::slice::from_raw_parts(input, (*state).size()),
+            std::slice::from_raw_parts_mut(output, (*state).complex_size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn fourier_transform_real_inverse_scratch_double(
+    state: *const Box<dyn fourier::RealFft<Real = f64> + Send + Sync>,
+    input: *const num_complex::Complex<f64>,
+    output: *mut f64,
+    scratch: *mut num_complex::Complex<f64>,
+    transform: c_int,
+) {
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+        (*state).inverse_with_scratch(
+            std::slice::from_raw_parts(input, (*state).complex_size()),
+            std::slice::from_raw_parts_mut(output, (*state).size()),
+            scratch_slice(scratch, (*state).scratch_size()),
+            convert_transform(transform),
+        );
+    }));
+}
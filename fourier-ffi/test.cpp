@@ -1,8 +1,13 @@
 #include "fourier.h"
 #include <array>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <new>
+#include <thread>
+#include <vector>
 
 template <typename C> void check(const C &input, const C &output) {
   for (std::size_t i = 0; i < 4; ++i) {
@@ -47,11 +52,252 @@ void test_c_double() {
   check(input, output);
 }
 
+template <typename T> void test_scratch() {
+  std::array<std::complex<T>, 4> input{{{1, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  std::array<std::complex<T>, 4> output;
+  fourier::fft<T> fft(input.size());
+  std::vector<std::complex<T>> scratch(fft.scratch_size());
+  fft.transform(input.data(), output.data(), scratch.data(),
+                fourier::transform::fft);
+  fft.transform_in_place(output.data(), scratch.data(),
+                         fourier::transform::ifft);
+  check(input, output);
+}
+
+template <typename T> void test_planner() {
+  std::array<std::complex<T>, 4> input{{{1, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  std::array<std::complex<T>, 4> output;
+  fourier::fft<T> fft(input.size(), fourier::planner::measure);
+  fft.transform(input.data(), output.data(), fourier::transform::fft);
+  fft.transform_in_place(output.data(), fourier::transform::ifft);
+  check(input, output);
+}
+
+void test_wisdom() {
+  // The planner tests have recorded wisdom
+  std::vector<unsigned char> wisdom = fourier::export_wisdom();
+  fourier::forget_wisdom();
+  if (fourier::import_wisdom({}) || fourier::import_wisdom({1, 2, 3}) ||
+      !fourier::import_wisdom(wisdom) ||
+      fourier::export_wisdom() != wisdom) {
+    std::cerr << "Wisdom mismatch" << std::endl;
+    std::exit(-1);
+  }
+  test_planner<float>();
+  test_planner<double>();
+}
+
+template <typename T> void test_batch() {
+  // Two interleaved vectors
+  std::array<std::complex<T>, 8> input{
+      {{1, 0}, {2, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  std::array<std::complex<T>, 8> output = input;
+  fourier::fft<T> fft(4);
+  fft.transform_batch_in_place(output.data(), 2, 2, 1, fourier::transform::fft);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    if (std::abs(output[i] - input[i % 2]) > 1e-10) {
+      std::cerr << "Mismatch at index " << i << std::endl;
+      std::exit(-1);
+    }
+  }
+  fft.transform_batch_in_place(output.data(), 2, 2, 1,
+                               fourier::transform::ifft);
+  check(input, output);
+
+  // Batches with overflowing indices are ignored
+  fft.transform_batch_in_place(output.data(), 2, 2,
+                               std::numeric_limits<std::size_t>::max(),
+                               fourier::transform::fft);
+  check(input, output);
+}
+
+template <typename T> void test_split() {
+  std::array<T, 4> re{{1, 2, 3, 4}};
+  std::array<T, 4> im{{0, 0, 0, 0}};
+  std::array<std::complex<T>, 4> expected{
+      {{10, 0}, {-2, 2}, {-2, 0}, {-2, -2}}};
+  fourier::fft<T> fft(re.size());
+  fft.transform_split_in_place(re.data(), im.data(), fourier::transform::fft);
+  for (std::size_t i = 0; i < re.size(); ++i) {
+    if (std::abs(std::complex<T>(re[i], im[i]) - expected[i]) > 1e-5) {
+      std::cerr << "Mismatch at index " << i << std::endl;
+      std::exit(-1);
+    }
+  }
+  std::vector<std::complex<T>> scratch(fft.split_scratch_size());
+  fft.transform_split_in_place(re.data(), im.data(), scratch.data(),
+                               fourier::transform::ifft);
+  check(std::array<T, 4>{{1, 2, 3, 4}}, re);
+  check(std::array<T, 4>{{0, 0, 0, 0}}, im);
+}
+
+template <typename T> void test_concurrent() {
+  std::array<std::complex<T>, 4> input{{{1, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  const fourier::fft<T> fft(input.size());
+  std::vector<std::array<std::complex<T>, 4>> outputs(8);
+  std::vector<std::thread> threads;
+  for (auto &output : outputs) {
+    threads.emplace_back([&input, &fft, &output]() {
+      for (int i = 0; i < 1000; ++i) {
+        fft.transform(input.data(), output.data(), fourier::transform::fft);
+        fft.transform_in_place(output.data(), fourier::transform::ifft);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (const auto &output : outputs)
+    check(input, output);
+}
+
+template <typename T> void test_cached() {
+  std::array<std::complex<T>, 4> input{{{1, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  std::array<std::complex<T>, 4> output;
+  {
+    auto first = fourier::fft<T>::cached(input.size());
+    auto second = fourier::fft<T>::cached(input.size());
+    first.transform(input.data(), output.data(), fourier::transform::fft);
+    second.transform_in_place(output.data(), fourier::transform::ifft);
+    check(input, output);
+    fourier::clear_fft_cache();
+    first.transform_in_place(output.data(), fourier::transform::fft);
+  }
+  auto fft = fourier::fft<T>::cached(input.size());
+  fft.transform_in_place(output.data(), fourier::transform::ifft);
+  check(input, output);
+}
+
+template <typename T> void test_compact() {
+  std::vector<std::complex<T>> input(1000);
+  for (std::size_t i = 0; i < input.size(); ++i)
+    input[i] = std::complex<T>(T(i % 13), T(i % 7));
+  std::vector<std::complex<T>> expected(input.size());
+  std::vector<std::complex<T>> output(input.size());
+  fourier::fft<T>(input.size())
+      .transform(input.data(), expected.data(), fourier::transform::fft);
+  auto fft = fourier::fft<T>::compact(input.size());
+  fft.transform(input.data(), output.data(), fourier::transform::fft);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    if (std::abs(output[i] - expected[i]) > 1e-2) {
+      std::cerr << "Mismatch at index " << i << std::endl;
+      std::exit(-1);
+    }
+  }
+  fft.transform_in_place(output.data(), fourier::transform::ifft);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    if (std::abs(output[i] - input[i]) > 1e-3) {
+      std::cerr << "Mismatch at index " << i << std::endl;
+      std::exit(-1);
+    }
+  }
+}
+
+template <typename T> void test_allocator() {
+  using vector =
+      std::vector<std::complex<T>, fourier::allocator<std::complex<T>>>;
+  for (std::size_t size : {4, 1000, 1 << 18}) {
+    vector input(size);
+    if (reinterpret_cast<std::uintptr_t>(input.data()) % 64 != 0) {
+      std::cerr << "Misaligned buffer of size " << size << std::endl;
+      std::exit(-1);
+    }
+    input[0] = 1;
+    vector output(size);
+    fourier::fft<T> fft(size);
+    fft.transform(input.data(), output.data(), fourier::transform::fft);
+    fft.transform_in_place(output.data(), fourier::transform::ifft);
+    for (std::size_t i = 0; i < size; ++i) {
+      if (std::abs(output[i] - input[i]) > 1e-5) {
+        std::cerr << "Mismatch at index " << i << std::endl;
+        std::exit(-1);
+      }
+    }
+  }
+
+  // Allocation failures are reported rather than aborting
+  try {
+    fourier::allocator<std::complex<T>>().allocate(
+        std::numeric_limits<std::size_t>::max() / 4);
+    std::cerr << "Impossible allocation succeeded" << std::endl;
+    std::exit(-1);
+  } catch (const std::bad_alloc &) {
+  }
+}
+
+template <typename T> void test_real() {
+  std::array<T, 4> input{{1, 2, 3, 4}};
+  std::array<std::complex<T>, 3> expected{{{10, 0}, {-2, 2}, {-2, 0}}};
+  std::array<std::complex<T>, 3> spectrum;
+  std::array<T, 4> output;
+  fourier::real_fft<T> fft(input.size());
+  fft.forward(input.data(), spectrum.data());
+  for (std::size_t i = 0; i < spectrum.size(); ++i) {
+    if (std::abs(spectrum[i] - expected[i]) > 1e-5) {
+      std::cerr << "Mismatch at index " << i << " (" << spectrum[i]
+                << " is not " << expected[i] << ")" << std::endl;
+      std::exit(-1);
+    }
+  }
+  std::vector<std::complex<T>> scratch(fft.scratch_size());
+  fft.inverse(spectrum.data(), output.data(), scratch.data());
+  check(input, output);
+}
+
+template <typename T> void test_multi() {
+  // The FFT of an impulse is constant
+  std::array<std::size_t, 2> dimensions{{3, 4}};
+  std::array<std::complex<T>, 12> input{};
+  input[0] = 1;
+  std::array<std::complex<T>, 12> output;
+  fourier::fft<T> fft(dimensions.data(), dimensions.size());
+  fft.transform(input.data(), output.data(), fourier::transform::fft);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    if (std::abs(output[i] - std::complex<T>(1)) > 1e-5) {
+      std::cerr << "Mismatch at index " << i << std::endl;
+      std::exit(-1);
+    }
+  }
+  fft.transform_in_place(output.data(), fourier::transform::ifft);
+  check(input, output);
+
+  // Empty dimensions are rejected
+  if (fourier::c::fourier_create_multi_float(nullptr, 0) ||
+      fourier::c::fourier_create_multi_double(dimensions.data(), 0)) {
+    std::cerr << "Created an FFT without dimensions" << std::endl;
+    std::exit(-1);
+  }
+}
+
 int main() {
   test<float>();
   test<double>();
   test_c_float();
   test_c_double();
+  test_scratch<float>();
+  test_scratch<double>();
+  test_planner<float>();
+  test_planner<double>();
+  test_wisdom();
+  test_batch<float>();
+  test_batch<double>();
+  test_split<float>();
+  test_split<double>();
+  test_concurrent<float>();
+  test_concurrent<double>();
+  test_cached<float>();
+  test_cached<double>();
+  test_compact<float>();
+  test_compact<double>();
+  test_allocator<float>();
+  test_allocator<double>();
+  fourier::set_threads(2);
+  test<float>();
+  test<double>();
+  fourier::set_threads(0);
+  test_real<float>();
+  test_real<double>();
+  test_multi<float>();
+  test_multi<double>();
   std::cout << "Tests ran successfully." << std::endl;
   return 0;
 }
@@ -2,6 +2,7 @@
 //! FFTs. This crate is reexported in the [`fourier`](../fourier/index.html) crate.
 
 extern crate proc_macro;
+use fourier_algorithms::{Fft, RealFft};
 use num_complex::Complex;
 use proc_macro2::{Span, TokenStream};
 use quote::{quote, ToTokens};
@@ -14,14 +15,29 @@ struct Config {
     pub ty: Ident,
     pub comma_token2: Token![,],
     pub len: LitInt,
+    pub real: bool,
 }
 
 impl Parse for Config {
     fn parse(input: ParseStream) -> Result<Self> {
+        let ty = input.parse()?;
+        let comma_token2 = input.parse()?;
+        let len = input.parse()?;
+        let real = if input.is_empty() {
+            false
+        } else {
+            input.parse::<Token![,]>()?;
+            let kind: Ident = input.parse()?;
+            if kind != "real" {
+                return Err(Error::new(kind.span(), "expected `real`"));
+            }
+            true
+        };
         Ok(Self {
-            ty: input.parse()?,
-            comma_token2: input.parse()?,
-            len: input.parse()?,
+            ty,
+            comma_token2,
+            len,
+            real,
         })
     }
 }
@@ -34,6 +50,9 @@ impl Parse for Config {
 /// size. This implementation does not require any heap allocations and is suitable for
 /// `#[no_std]` usage.
 ///
+/// An optional third argument, `real`, implements [`RealFft`] instead of [`Fft`], for example
+/// `#[static_fft(f32, 128, real)]`.
+///
 /// The following implements `Fft<Real = f32>` and `Default` for `StaticFft`:
 /// ```
 /// # use fourier_macros::static_fft;
@@ -46,6 +65,7 @@ impl Parse for Config {
 /// ```
 ///
 /// [`Fft`]: ../fourier/trait.Fft.html
+/// [`RealFft`]: ../fourier/trait.RealFft.html
 /// [`Default`]: https://doc.rust-lang.org/std/default/trait.Default.html
 #[proc_macro_attribute]
 pub fn static_fft(
@@ -105,137 +125,507 @@ macro_rules! implement {
             let ty: Ident = parse_quote! { $type };
             let size = config.len.base10_parse::<usize>()?;
             let name = item.ident.clone();
+            // Nested FFTs must not shadow the tagged struct
+            let inner_name = Ident::new(&format!("{}Inner", name), Span::call_site());
+            if config.real {
+                type PackedRealFft<F> = fourier_algorithms::PackedRealFft<$type, F, CplxVec, CplxVec>;
+                let inner_fft_size = fourier_algorithms::real_inner_fft_size(size);
+                let (twiddles, work_size) = if Autosort::new(inner_fft_size).is_some() {
+                    let fft = PackedRealFft::<Autosort>::new_with_fft(size, |size| Autosort::new(size).unwrap());
+                    (fft.twiddles().to_vec(), fft.scratch_size())
+                } else {
+                    let fft = PackedRealFft::<Bluesteins>::new_with_fft(size, Bluesteins::new);
+                    (fft.twiddles().to_vec(), fft.scratch_size())
+                };
+                let (twiddles, twiddles_type) = to_array_complex(&ty, &twiddles);
+                return Ok(quote! {
+                    #[derive(Default)]
+                    #item
+
+                    const _: () = {
+                        use fourier_algorithms::RealFft;
+                        use num_complex::Complex;
+
+                        #[fourier::static_fft($type, #inner_fft_size)]
+                        struct #inner_name;
+
+                        // Work around 32 element trait limit
+                        struct Twiddles(#twiddles_type);
+                        impl AsRef<[Complex<$type>]> for Twiddles {
+                            fn as_ref(&self) -> &[Complex<$type>] {
+                                &self.0
+                            }
+                        }
+
+                        // Work is allocated on the stack for each transform
+                        struct Work([Complex<$type>; #work_size]);
+                        impl Default for Work {
+                            fn default() -> Self {
+                                Work([Complex::<#ty>::new(0., 0.); #work_size])
+                            }
+                        }
+                        // The buffer has `scratch_size()` elements, so `allocate_work` never
+                        // needs to grow it
+                        impl Extend<Complex<$type>> for Work {
+                            fn extend<I: IntoIterator<Item = Complex<$type>>>(&mut self, iter: I) {
+                                assert!(
+                                    iter.into_iter().next().is_none(),
+                                    "static work buffer is smaller than the requested size"
+                                );
+                            }
+                        }
+                        impl AsMut<[Complex<$type>]> for Work {
+                            fn as_mut(&mut self) -> &mut [Complex<$type>] {
+                                &mut self.0
+                            }
+                        }
+
+                        static TWIDDLES: Twiddles = Twiddles(#twiddles);
+
+                        fn real_fft() -> fourier_algorithms::PackedRealFft<$type, #inner_name, &'static Twiddles, Work> {
+                            unsafe {
+                                fourier_algorithms::PackedRealFft::new_from_parts(
+                                    #size,
+                                    #inner_name,
+                                    &TWIDDLES,
+                                )
+                            }
+                        }
+
+                        impl RealFft for #name {
+                            type Real = #ty;
+
+                            fn size(&self) -> usize {
+                                #size
+                            }
+
+                            fn scratch_size(&self) -> usize {
+                                #work_size
+                            }
+
+                            fn forward(
+                                &self,
+                                input: &[Self::Real],
+                                output: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                real_fft().forward(input, output, transform);
+                            }
+
+                            fn forward_with_scratch(
+                                &self,
+                                input: &[Self::Real],
+                                output: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                real_fft().forward_with_scratch(input, output, scratch, transform);
+                            }
+
+                            fn inverse(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Self::Real],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                real_fft().inverse(input, output, transform);
+                            }
+
+                            fn inverse_with_scratch(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Self::Real],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                real_fft().inverse_with_scratch(input, output, scratch, transform);
+                            }
+                        }
+                    };
+                });
+            }
             let usize_ty: Ident = parse_quote!{ usize };
             if let Some(autosort) = Autosort::new(size) {
-                let (forward_twiddles, twiddles_type) = to_array_complex(&ty, autosort.twiddles().0);
-                let (inverse_twiddles, _) = to_array_complex(&ty, autosort.twiddles().1);
+                let (twiddles, twiddles_type) = to_array_complex(&ty, autosort.twiddles());
                 let (counts, counts_type) = to_array(&usize_ty, &autosort.counts());
-                let work_size = autosort.work_size();
+                let (generic_radices, generic_radices_type) =
+                    to_array(&usize_ty, &autosort.generic_radices());
+                let work_size = autosort.scratch_size();
                 let work_type = quote!{ [Complex<$type>; #work_size] };
-                let autosort_type = quote!{ fourier_algorithms::Autosort::<$type, &'static Twiddles, Work> };
                 Ok(quote! {
                     #[derive(Default)]
                     #item
 
-                    impl fourier_algorithms::Fft for #name {
-                        type Real = #ty;
+                    const _: () = {
+                        use fourier_algorithms::Fft;
+                        use num_complex::Complex;
 
-                        fn size(&self) -> usize {
-                            #size
+                        // Work around 32 element trait limit
+                        struct Twiddles(#twiddles_type);
+                        impl AsRef<[Complex<$type>]> for Twiddles {
+                            fn as_ref(&self) -> &[Complex<$type>] {
+                                &self.0
+                            }
                         }
 
-                        fn transform_in_place(
-                            &self,
-                            input: &mut [num_complex::Complex<Self::Real>],
-                            transform: fourier_algorithms::Transform,
-                        ) {
-                            use fourier_algorithms::Fft;
-                            use num_complex::Complex;
-
-                            // Work around 32 element trait limit
-                            struct Twiddles(#twiddles_type);
-                            impl AsRef<[Complex<$type>]> for Twiddles {
-                                fn as_ref(&self) -> &[Complex<$type>] {
-                                    &self.0
-                                }
+                        // Work is allocated on the stack for each transform
+                        struct Work(#work_type);
+                        impl Default for Work {
+                            fn default() -> Self {
+                                Work([Complex::<#ty>::new(0., 0.); #work_size])
                             }
-
-                            struct Work(#work_type);
-                            impl AsMut<[Complex<$type>]> for Work {
-                                fn as_mut(&mut self) -> &mut [Complex<$type>] {
-                                    &mut self.0
-                                }
+                        }
+                        // The buffer has `scratch_size()` elements, so `allocate_work` never
+                        // needs to grow it
+                        impl Extend<Complex<$type>> for Work {
+                            fn extend<I: IntoIterator<Item = Complex<$type>>>(&mut self, iter: I) {
+                                assert!(
+                                    iter.into_iter().next().is_none(),
+                                    "static work buffer is smaller than the requested size"
+                                );
                             }
+                        }
+                        impl AsMut<[Complex<$type>]> for Work {
+                            fn as_mut(&mut self) -> &mut [Complex<$type>] {
+                                &mut self.0
+                            }
+                        }
 
-                            const COUNTS: #counts_type = #counts;
-                            const WORK: Work = Work([Complex::<#ty>::new(0., 0.); #work_size]);
+                        const COUNTS: #counts_type = #counts;
+                        const GENERIC_RADICES: #generic_radices_type = #generic_radices;
 
-                            // Twiddles are shared between all instances
-                            static FORWARD_TWIDDLES: Twiddles = Twiddles(#forward_twiddles);
-                            static INVERSE_TWIDDLES: Twiddles = Twiddles(#inverse_twiddles);
+                        // Twiddles are shared between all instances
+                        static TWIDDLES: Twiddles = Twiddles(#twiddles);
 
-                            let autosort = unsafe {
-                                #autosort_type::new_from_parts(
+                        fn autosort() -> fourier_algorithms::Autosort<$type, &'static Twiddles, Work> {
+                            unsafe {
+                                fourier_algorithms::Autosort::new_from_parts(
                                     #size,
                                     COUNTS,
-                                    &FORWARD_TWIDDLES,
-                                    &INVERSE_TWIDDLES,
-                                    WORK,
+                                    GENERIC_RADICES,
+                                    &TWIDDLES,
                                 )
-                            };
-                            autosort.transform_in_place(input, transform);
+                            }
+                        }
+
+                        impl Fft for #name {
+                            type Real = #ty;
+
+                            fn size(&self) -> usize {
+                                #size
+                            }
+
+                            fn scratch_size(&self) -> usize {
+                                #work_size
+                            }
+
+                            fn transform_in_place(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform_in_place(input, transform);
+                            }
+
+                            fn transform_in_place_with_scratch(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform_in_place_with_scratch(input, scratch, transform);
+                            }
+
+                            fn transform(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform(input, output, transform);
+                            }
+
+                            fn transform_with_scratch(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform_with_scratch(input, output, scratch, transform);
+                            }
+
+                            fn fft_multiply_in_place_with_scratch(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                factors: &[Complex<Self::Real>],
+                                conjugate: bool,
+                            ) {
+                                autosort().fft_multiply_in_place_with_scratch(input, scratch, factors, conjugate);
+                            }
+
+                            fn transform_batch_in_place(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                count: usize,
+                                stride: usize,
+                                distance: usize,
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                let mut scratch = [Complex::<#ty>::new(0., 0.); #size + #work_size];
+                                autosort().transform_batch_in_place_with_scratch(
+                                    input,
+                                    count,
+                                    stride,
+                                    distance,
+                                    &mut scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn transform_batch_in_place_with_scratch(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                count: usize,
+                                stride: usize,
+                                distance: usize,
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform_batch_in_place_with_scratch(
+                                    input,
+                                    count,
+                                    stride,
+                                    distance,
+                                    scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn split_scratch_size(&self) -> usize {
+                                autosort().split_scratch_size()
+                            }
+
+                            fn transform_split_in_place(
+                                &self,
+                                real: &mut [Self::Real],
+                                imag: &mut [Self::Real],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                let mut scratch = [Complex::<#ty>::new(0., 0.); #size + #work_size];
+                                autosort().transform_split_in_place_with_scratch(
+                                    real,
+                                    imag,
+                                    &mut scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn transform_split_in_place_with_scratch(
+                                &self,
+                                real: &mut [Self::Real],
+                                imag: &mut [Self::Real],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                autosort().transform_split_in_place_with_scratch(
+                                    real,
+                                    imag,
+                                    scratch,
+                                    transform,
+                                );
+                            }
                         }
-                    }
+                    };
                 })
             } else {
                 let bluesteins = Bluesteins::new(size);
-                let (forward_w_twiddles, w_twiddles_type) = to_array_complex(&ty, bluesteins.w_twiddles().0);
-                let (inverse_w_twiddles, _) = to_array_complex(&ty, bluesteins.w_twiddles().1);
-                let (forward_x_twiddles, x_twiddles_type) = to_array_complex(&ty, bluesteins.x_twiddles().0);
-                let (inverse_x_twiddles, _) = to_array_complex(&ty, bluesteins.x_twiddles().1);
-                let work_size = bluesteins.work_size();
+                let (w_twiddles, w_twiddles_type) = to_array_complex(&ty, bluesteins.w_twiddles());
+                let (x_twiddles, x_twiddles_type) = to_array_complex(&ty, bluesteins.x_twiddles());
+                let work_size = bluesteins.scratch_size();
                 let inner_fft_size = bluesteins.inner_fft_size();
                 Ok(quote! {
                     #item
 
-                    impl fourier_algorithms::Fft for #name {
-                        type Real = #ty;
+                    const _: () = {
+                        use fourier_algorithms::Fft;
+                        use num_complex::Complex;
+
+                        #[fourier::static_fft($type, #inner_fft_size)]
+                        struct #inner_name;
 
-                        fn size(&self) -> usize {
-                            #size
+                        // Work around 32 element trait limit
+                        struct WTwiddles(#w_twiddles_type);
+                        impl AsRef<[Complex<$type>]> for WTwiddles {
+                            fn as_ref(&self) -> &[Complex<$type>] {
+                                &self.0
+                            }
+                        }
+                        struct XTwiddles(#x_twiddles_type);
+                        impl AsRef<[Complex<$type>]> for XTwiddles {
+                            fn as_ref(&self) -> &[Complex<$type>] {
+                                &self.0
+                            }
+                        }
+
+                        // Work is allocated on the stack for each transform
+                        struct Work([Complex<$type>; #work_size]);
+                        impl Default for Work {
+                            fn default() -> Self {
+                                Work([Complex::<#ty>::new(0., 0.); #work_size])
+                            }
+                        }
+                        // The buffer has `scratch_size()` elements, so `allocate_work` never
+                        // needs to grow it
+                        impl Extend<Complex<$type>> for Work {
+                            fn extend<I: IntoIterator<Item = Complex<$type>>>(&mut self, iter: I) {
+                                assert!(
+                                    iter.into_iter().next().is_none(),
+                                    "static work buffer is smaller than the requested size"
+                                );
+                            }
+                        }
+                        impl AsMut<[Complex<$type>]> for Work {
+                            fn as_mut(&mut self) -> &mut [Complex<$type>] {
+                                &mut self.0
+                            }
                         }
 
-                        fn transform_in_place(
-                            &self,
-                            input: &mut [num_complex::Complex<Self::Real>],
-                            transform: fourier_algorithms::Transform,
-                        ) {
-                            #[fourier::static_fft($type, #inner_fft_size)]
-                            struct InnerFft;
-
-                            use num_complex::Complex;
-                            use fourier_algorithms::Fft;
-                            type WorkArray = [Complex<$type>; #work_size];
-
-                            // Work around 32 element trait limit
-                            struct WTwiddles(#w_twiddles_type);
-                            impl AsRef<[Complex<$type>]> for WTwiddles {
-                                fn as_ref(&self) -> &[Complex<$type>] {
-                                    &self.0
-                                }
-                            }
-                            struct XTwiddles(#x_twiddles_type);
-                            impl AsRef<[Complex<$type>]> for XTwiddles {
-                                fn as_ref(&self) -> &[Complex<$type>] {
-                                    &self.0
-                                }
-                            }
-                            struct Work(WorkArray);
-                            impl AsMut<[Complex<$type>]> for Work {
-                                fn as_mut(&mut self) -> &mut [Complex<$type>] {
-                                    &mut self.0
-                                }
-                            }
-
-                            static FORWARD_W_TWIDDLES: WTwiddles = WTwiddles(#forward_w_twiddles);
-                            static INVERSE_W_TWIDDLES: WTwiddles = WTwiddles(#inverse_w_twiddles);
-                            static FORWARD_X_TWIDDLES: XTwiddles = XTwiddles(#forward_x_twiddles);
-                            static INVERSE_X_TWIDDLES: XTwiddles = XTwiddles(#inverse_x_twiddles);
-                            const WORK: Work = Work([Complex::<#ty>::new(0., 0.); #work_size]);
-                            let bluesteins = unsafe {
-                                fourier_algorithms::Bluesteins::<$type, InnerFft, &WTwiddles, &XTwiddles, Work>::new_from_parts(
+                        static W_TWIDDLES: WTwiddles = WTwiddles(#w_twiddles);
+                        static X_TWIDDLES: XTwiddles = XTwiddles(#x_twiddles);
+
+                        fn bluesteins() -> fourier_algorithms::Bluesteins<$type, #inner_name, &'static WTwiddles, &'static XTwiddles, Work> {
+                            unsafe {
+                                fourier_algorithms::Bluesteins::new_from_parts(
                                     #size,
-                                    InnerFft::default(),
-                                    &FORWARD_W_TWIDDLES,
-                                    &INVERSE_W_TWIDDLES,
-                                    &FORWARD_X_TWIDDLES,
-                                    &INVERSE_X_TWIDDLES,
-                                    WORK,
+                                    #inner_name::default(),
+                                    &W_TWIDDLES,
+                                    &X_TWIDDLES,
                                 )
-                            };
-                            bluesteins.transform_in_place(input, transform);
+                            }
+                        }
+
+                        impl Fft for #name {
+                            type Real = #ty;
+
+                            fn size(&self) -> usize {
+                                #size
+                            }
+
+                            fn scratch_size(&self) -> usize {
+                                #work_size
+                            }
+
+                            fn transform_in_place(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform_in_place(input, transform);
+                            }
+
+                            fn transform_in_place_with_scratch(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform_in_place_with_scratch(input, scratch, transform);
+                            }
+
+                            fn transform(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform(input, output, transform);
+                            }
+
+                            fn transform_with_scratch(
+                                &self,
+                                input: &[Complex<Self::Real>],
+                                output: &mut [Complex<Self::Real>],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform_with_scratch(input, output, scratch, transform);
+                            }
+
+                            fn transform_batch_in_place(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                count: usize,
+                                stride: usize,
+                                distance: usize,
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                let mut scratch = [Complex::<#ty>::new(0., 0.); #size + #work_size];
+                                bluesteins().transform_batch_in_place_with_scratch(
+                                    input,
+                                    count,
+                                    stride,
+                                    distance,
+                                    &mut scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn transform_batch_in_place_with_scratch(
+                                &self,
+                                input: &mut [Complex<Self::Real>],
+                                count: usize,
+                                stride: usize,
+                                distance: usize,
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform_batch_in_place_with_scratch(
+                                    input,
+                                    count,
+                                    stride,
+                                    distance,
+                                    scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn split_scratch_size(&self) -> usize {
+                                bluesteins().split_scratch_size()
+                            }
+
+                            fn transform_split_in_place(
+                                &self,
+                                real: &mut [Self::Real],
+                                imag: &mut [Self::Real],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                let mut scratch = [Complex::<#ty>::new(0., 0.); #size + #work_size];
+                                bluesteins().transform_split_in_place_with_scratch(
+                                    real,
+                                    imag,
+                                    &mut scratch,
+                                    transform,
+                                );
+                            }
+
+                            fn transform_split_in_place_with_scratch(
+                                &self,
+                                real: &mut [Self::Real],
+                                imag: &mut [Self::Real],
+                                scratch: &mut [Complex<Self::Real>],
+                                transform: fourier_algorithms::Transform,
+                            ) {
+                                bluesteins().transform_split_in_place_with_scratch(
+                                    real,
+                                    imag,
+                                    scratch,
+                                    transform,
+                                );
+                            }
                         }
-                    }
+                    };
                 })
             }
         }
@@ -0,0 +1,243 @@
+//! Heap buffers with cache line (or huge page) alignment.
+
+#[cfg(not(feature = "std"))]
+use alloc::alloc::{alloc_zeroed, dealloc, handle_alloc_error, Layout};
+use core::ptr::NonNull;
+#[cfg(feature = "std")]
+use std::alloc::{alloc_zeroed, dealloc, handle_alloc_error, Layout};
+
+/// The alignment of every buffer, in bytes.  This is the cache line size of most processors, and
+/// at least the width of every vector register used by the kernels.
+pub const ALIGNMENT: usize = 64;
+
+/// Buffers of at least this many bytes are aligned to this size, and on Linux the kernel is
+/// advised to back them with transparent huge pages.
+pub const HUGE_PAGE_SIZE: usize = 2 << 20;
+
+/// A growable heap buffer aligned to [`ALIGNMENT`] bytes.
+///
+/// Large buffers (of at least [`HUGE_PAGE_SIZE`] bytes) are aligned to, and sized in multiples
+/// of, [`HUGE_PAGE_SIZE`].  With the `std` feature on Linux, they are also advised to use
+/// transparent huge pages, reducing TLB misses when transforming multi-megabyte FFTs.
+///
+/// This is the storage used for twiddle factors and work buffers by the FFTs created by this
+/// crate.  It may be used for transform buffers as well, though any buffer is accepted.
+///
+/// [`ALIGNMENT`]: constant.ALIGNMENT.html
+/// [`HUGE_PAGE_SIZE`]: constant.HUGE_PAGE_SIZE.html
+pub struct AlignedVec<T: Copy> {
+    ptr: NonNull<T>,
+    len: usize,
+    capacity: usize,
+}
+
+unsafe impl<T: Copy + Send> Send for AlignedVec<T> {}
+unsafe impl<T: Copy + Sync> Sync for AlignedVec<T> {}
+
+/// Returns the layout of a buffer of at least `bytes` bytes, or `None` if it is too large.
+fn layout(bytes: usize) -> Option<Layout> {
+    let (size, align) = if bytes >= HUGE_PAGE_SIZE {
+        let size = bytes.checked_add(HUGE_PAGE_SIZE - 1)? / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        (size, HUGE_PAGE_SIZE)
+    } else {
+        (bytes, ALIGNMENT)
+    };
+    Layout::from_size_align(size, align).ok()
+}
+
+/// Advises the kernel to back a large allocation with transparent huge pages.
+#[cfg(all(feature = "std", target_os = "linux"))]
+fn advise_huge_pages(ptr: *mut u8, layout: Layout) {
+    if layout.align() == HUGE_PAGE_SIZE {
+        // This is only advice, so failure (such as when transparent huge pages are disabled) is
+        // ignored.
+        unsafe {
+            libc::madvise(ptr as *mut _, layout.size(), libc::MADV_HUGEPAGE);
+        }
+    }
+}
+
+#[cfg(not(all(feature = "std", target_os = "linux")))]
+fn advise_huge_pages(_ptr: *mut u8, _layout: Layout) {}
+
+impl<T: Copy> AlignedVec<T> {
+    /// Create an empty buffer.  No memory is allocated.
+    pub fn new() -> Self {
+        assert!(
+            core::mem::size_of::<T>() != 0,
+            "zero-sized types are not supported"
+        );
+        assert!(core::mem::align_of::<T>() <= ALIGNMENT);
+        Self {
+            ptr: NonNull::dangling(),
+            len: 0,
+            capacity: 0,
+        }
+    }
+
+    /// Create a buffer of `len` elements with every byte set to zero.
+    pub fn zeroed(len: usize) -> Self {
+        let mut buffer = Self::new();
+        buffer.reserve(len);
+        buffer.len = len;
+        buffer
+    }
+
+    /// Create a buffer of `len` elements with every byte set to zero, or return `None` if the
+    /// allocation fails.
+    pub fn try_zeroed(len: usize) -> Option<Self> {
+        let mut buffer = Self::new();
+        buffer.try_reserve(len).ok()?;
+        buffer.len = len;
+        Some(buffer)
+    }
+
+    /// Create a buffer from a pointer, length, and capacity returned by
+    /// [`into_raw_parts`](#method.into_raw_parts).
+    pub unsafe fn from_raw_parts(ptr: *mut T, len: usize, capacity: usize) -> Self {
+        Self {
+            ptr: NonNull::new_unchecked(ptr),
+            len,
+            capacity,
+        }
+    }
+
+    /// Decompose the buffer into a pointer, length, and capacity, without freeing it.
+    pub fn into_raw_parts(self) -> (*mut T, usize, usize) {
+        let parts = (self.ptr.as_ptr(), self.len, self.capacity);
+        core::mem::forget(self);
+        parts
+    }
+
+    /// Return the number of elements in the buffer.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Return true if the buffer contains no elements.
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Return the number of elements the buffer can hold without reallocating.
+    pub fn capacity(&self) -> usize {
+        self.capacity
+    }
+
+    /// Reserve space for at least `additional` more elements.
+    pub fn reserve(&mut self, additional: usize) {
+        match self.try_reserve(additional) {
+            Ok(()) => {}
+            Err(Some(layout)) => handle_alloc_error(layout),
+            Err(None) => panic!("buffer too large"),
+        }
+    }
+
+    /// Reserve space for at least `additional` more elements.
+    ///
+    /// On failure, returns the layout that could not be allocated, or `None` if the buffer would
+    /// be too large to describe.  The buffer is unchanged.
+    fn try_reserve(&mut self, additional: usize) -> Result<(), Option<Layout>> {
+        let required = self.len.checked_add(additional).ok_or(None)?;
+        if required <= self.capacity {
+            return Ok(());
+        }
+        let capacity = required.max(2 * self.capacity);
+        let layout = capacity
+            .checked_mul(core::mem::size_of::<T>())
+            .and_then(layout)
+            .ok_or(None)?;
+        unsafe {
+            let ptr = alloc_zeroed(layout);
+            if ptr.is_null() {
+                return Err(Some(layout));
+            }
+            advise_huge_pages(ptr, layout);
+            let ptr = ptr as *mut T;
+            core::ptr::copy_nonoverlapping(self.ptr.as_ptr(), ptr, self.len);
+            self.free();
+            self.ptr = NonNull::new_unchecked(ptr);
+        }
+        self.capacity = layout.size() / core::mem::size_of::<T>();
+        Ok(())
+    }
+
+    /// Remove every element, keeping the allocation.
+    pub fn clear(&mut self) {
+        self.len = 0;
+    }
+
+    unsafe fn free(&mut self) {
+        if self.capacity != 0 {
+            dealloc(
+                self.ptr.as_ptr() as *mut u8,
+                layout(self.capacity * core::mem::size_of::<T>()).unwrap(),
+            );
+        }
+    }
+}
+
+impl<T: Copy> Drop for AlignedVec<T> {
+    fn drop(&mut self) {
+        unsafe { self.free() }
+    }
+}
+
+impl<T: Copy> Default for AlignedVec<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<T: Copy> Clone for AlignedVec<T> {
+    fn clone(&self) -> Self {
+        let mut buffer = Self::new();
+        buffer.extend(self.iter().copied());
+        buffer
+    }
+}
+
+impl<T: Copy + core::fmt::Debug> core::fmt::Debug for AlignedVec<T> {
+    fn fmt(&self, f: &mut core::fmt::Formatter) -> core::fmt::Result {
+        f.debug_list().entries(self.iter()).finish()
+    }
+}
+
+impl<T: Copy> core::ops::Deref for AlignedVec<T> {
+    type Target = [T];
+    fn deref(&self) -> &[T] {
+        unsafe { core::slice::from_raw_parts(self.ptr.as_ptr(), self.len) }
+    }
+}
+
+impl<T: Copy> core::ops::DerefMut for AlignedVec<T> {
+    fn deref_mut(&mut self) -> &mut [T] {
+        unsafe { core::slice::from_raw_parts_mut(self.ptr.as_ptr(), self.len) }
+    }
+}
+
+impl<T: Copy> AsRef<[T]> for AlignedVec<T> {
+    fn as_ref(&self) -> &[T] {
+        self
+    }
+}
+
+impl<T: Copy> AsMut<[T]> for AlignedVec<T> {
+    fn as_mut(&mut self) -> &mut [T] {
+        self
+    }
+}
+
+impl<T: Copy> Extend<T> for AlignedVec<T> {
+    fn extend<I: IntoIterator<Item = T>>(&mut self, iter: I) {
+        let iter = iter.into_iter();
+        self.reserve(iter.size_hint().0);
+        for value in iter {
+            if self.len == self.capacity {
+                self.reserve(1);
+            }
+            unsafe { self.ptr.as_ptr().add(self.len).write(value) };
+            self.len += 1;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//! Sharing FFTs of the same size across the process.
+
+use crate::global::Global;
+use crate::{create_fft_f32, create_fft_f64, Fft};
+use std::collections::BTreeMap;
+use std::sync::{Arc, Mutex};
+
+type Cache<T> = Mutex<BTreeMap<usize, Arc<dyn Fft<Real = T> + Send + Sync>>>;
+
+static CACHE_F32: Global<Cache<f32>> = Global::new();
+static CACHE_F64: Global<Cache<f64>> = Global::new();
+
+fn cache<T>(cache: &'static Global<Cache<T>>) -> &'static Cache<T> {
+    cache.get(|| Mutex::new(BTreeMap::new()))
+}
+
+macro_rules! implement {
+    {
+        $type:ty, $name:ident, $create:ident, $cache:ident
+    } => {
+        /// Return a shared complex-valued FFT with the specified size.
+        ///
+        /// The first request for each size creates the FFT with the estimating planner (or
+        /// imported wisdom), and every later request returns the same FFT, so twiddle factors and
+        /// other tables are computed once per process.  FFTs are immutable and may be used
+        /// concurrently, so the cached FFT can be shared freely between threads.
+        pub fn $name(size: usize) -> Arc<dyn Fft<Real = $type> + Send + Sync> {
+            if let Some(fft) = cache(&$cache).lock().unwrap().get(&size) {
+                return fft.clone();
+            }
+
+            // Plan without holding the lock, so other sizes aren't blocked.  If another thread
+            // planned the same size in the meantime, keep its FFT.
+            let fft = Arc::from($create(size));
+            cache(&$cache).lock().unwrap().entry(size).or_insert(fft).clone()
+        }
+    }
+}
+implement! { f32, cached_fft_f32, create_fft_f32, CACHE_F32 }
+implement! { f64, cached_fft_f64, create_fft_f64, CACHE_F64 }
+
+/// Remove every FFT from the cache used by [`cached_fft_f32`] and [`cached_fft_f64`].
+///
+/// FFTs that are still in use remain valid.  This is useful after importing wisdom, since cached
+/// FFTs are not replanned.
+///
+/// [`cached_fft_f32`]: fn.cached_fft_f32.html
+/// [`cached_fft_f64`]: fn.cached_fft_f64.html
+pub fn clear_fft_cache() {
+    cache(&CACHE_F32).lock().unwrap().clear();
+    cache(&CACHE_F64).lock().unwrap().clear();
+}
@@ -0,0 +1,36 @@
+//! Lazily initialized process-wide values.
+
+use std::sync::atomic::{AtomicPtr, Ordering};
+use std::sync::Once;
+
+/// A process-wide value, initialized on first use and never freed.
+///
+/// This is usable in a `static` on every supported compiler (`Mutex::new` and `BTreeMap::new`
+/// are not `const` on older ones).
+pub struct Global<T> {
+    once: Once,
+    value: AtomicPtr<T>,
+}
+
+impl<T> Global<T> {
+    /// Create an uninitialized value.
+    pub const fn new() -> Self {
+        Self {
+            once: Once::new(),
+            value: AtomicPtr::new(core::ptr::null_mut()),
+        }
+    }
+}
+
+impl<T: Sync> Global<T> {
+    /// Return the value, initializing it with `init` if this is the first use.
+    pub fn get(&'static self, init: impl FnOnce() -> T) -> &'static T {
+        let value = &self.value;
+        self.once.call_once(|| {
+            value.store(Box::into_raw(Box::new(init())), Ordering::Release);
+        });
+        // Safety: the pointer was set by `call_once` above (which synchronizes with every other
+        // caller) and is never freed.
+        unsafe { &*self.value.load(Ordering::Acquire) }
+    }
+}
@@ -1,9 +1,59 @@
 //! This crate provides fast Fourier transforms (FFT) in pure Rust.
 //!
 //! # Implementation
-//! For FFTs with sizes that are multiples of 2 and 3, the Stockham auto-sort algorithm is used.
+//! For FFTs with sizes that are multiples of 2, 3, 5, and 7, the Stockham auto-sort algorithm is
+//! used.  Other prime factors up to 61 are performed by generic radix stages within the auto-sort
+//! algorithm.  Prime sizes use Rader's algorithm when the size less one is inexpensive to transform.
 //! For any other sizes, Bluestein's algorithm is used.
 //!
+//! Very large auto-sort sizes use the four-step algorithm, which splits the FFT into two sets of
+//! smaller FFTs that fit in cache, separated by a twiddle and transposition pass.
+//!
+//! These choices are made with a cost estimate.  Alternatively, [`Planner::Measure`] times the
+//! candidate algorithms and auto-sort factorizations on the running machine and keeps the fastest.
+//! Measured decisions can be saved with [`export_wisdom`] and restored in another process with
+//! [`import_wisdom`], after which every planner uses them without measuring.
+//!
+//! Multidimensional FFTs apply a one-dimensional FFT along each axis.  Axes other than the
+//! innermost are transformed in small tiles that are transposed into a contiguous buffer, rather
+//! than by transposing the entire array.
+//!
+//! Real-valued FFTs of even size are computed with a complex FFT of half the size, followed by a
+//! post-processing pass.  Only the non-redundant `N / 2 + 1` elements of the spectrum are stored.
+//!
+//! # Thread safety
+//! FFTs created by this crate are `Send` and `Sync`.  A single FFT may be applied concurrently from
+//! any number of threads.  Work buffers are not stored in the FFT; with the `std` feature they are
+//! taken from a bounded per-thread pool (buffers larger than 16 MiB are not kept), and otherwise
+//! they are allocated for each transform.
+//!
+//! Alternatively, a scratch buffer may be provided to [`Fft::transform_in_place_with_scratch`] or
+//! [`Fft::transform_with_scratch`].  The required size is given by [`Fft::scratch_size`], and a
+//! single buffer may be reused by FFTs of any size.
+//!
+//! Twiddle factors and work buffers are stored in [`AlignedVec`], which aligns them to cache
+//! lines and backs multi-megabyte buffers with huge pages where available.  The same type can be
+//! used for transform buffers.
+//!
+//! Where memory is more important than speed, [`create_compact_fft_f32`] and
+//! [`create_compact_fft_f64`] store a fraction of the twiddle factors and compute the rest as
+//! needed.
+//!
+//! Plans that are created repeatedly can be shared with [`cached_fft_f32`] and
+//! [`cached_fft_f64`], which create each size once per process and return it behind an `Arc`.
+//!
+//! [`Fft::transform_in_place_with_scratch`]: trait.Fft.html#method.transform_in_place_with_scratch
+//! [`Fft::transform_with_scratch`]: trait.Fft.html#method.transform_with_scratch
+//! [`Fft::scratch_size`]: trait.Fft.html#method.scratch_size
+//! [`AlignedVec`]: struct.AlignedVec.html
+//! [`create_compact_fft_f32`]: fn.create_compact_fft_f32.html
+//! [`create_compact_fft_f64`]: fn.create_compact_fft_f64.html
+//! [`cached_fft_f32`]: fn.cached_fft_f32.html
+//! [`cached_fft_f64`]: fn.cached_fft_f64.html
+//! [`Planner::Measure`]: enum.Planner.html#variant.Measure
+//! [`export_wisdom`]: fn.export_wisdom.html
+//! [`import_wisdom`]: fn.import_wisdom.html
+//!
 //! # Optional features
 //! Fourier uses optional features to allow versatility with `#[no_std]`.
 //! -  **`std`** *(enabled by default)* - Uses heap allocation for runtime-sized FFTs.  Enables
@@ -11,8 +61,14 @@
 //!    detection is performed.
 //! -  **`alloc`** - Enables heap allocation for runtime-sized FFTs with `#[no_std]` using the
 //!    [`alloc`] crate.
+//! -  **`parallel`** - Splits very large FFTs across threads in the [`rayon`] thread pool.  The
+//!    number of threads used by a single transform is limited with [`set_threads`].
+//! -  **`avx512`** - Adds AVX-512 versions of the kernels, selected at runtime like the others.
+//!    Requires Rust 1.89 or newer.
 //!
 //! [`alloc`]: https://doc.rust-lang.org/alloc/
+//! [`rayon`]: https://docs.rs/rayon
+//! [`set_threads`]: fn.set_threads.html
 #![cfg_attr(not(feature = "std"), no_std)]
 
 #[cfg(all(not(feature = "std"), feature = "alloc"))]
@@ -21,22 +77,99 @@ extern crate alloc;
 #[cfg(all(not(feature = "std"), feature = "alloc"))]
 use alloc::{boxed::Box, vec::Vec};
 
-pub use fourier_algorithms::{Fft, Transform};
+pub use fourier_algorithms::{set_threads, threads, Fft, RealFft, Transform};
 pub use fourier_macros::static_fft;
 
+#[cfg(any(feature = "std", feature = "alloc"))]
+mod aligned;
+#[cfg(feature = "std")]
+mod cache;
+#[cfg(feature = "std")]
+mod global;
+#[cfg(feature = "std")]
+mod planner;
+#[cfg(feature = "std")]
+mod wisdom;
+#[cfg(feature = "std")]
+mod work;
+
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub use aligned::{AlignedVec, ALIGNMENT, HUGE_PAGE_SIZE};
+#[cfg(feature = "std")]
+pub use cache::{cached_fft_f32, cached_fft_f64, clear_fft_cache};
+#[cfg(feature = "std")]
+pub use planner::Planner;
+#[cfg(feature = "std")]
+pub use wisdom::{export_wisdom, forget_wisdom, import_wisdom, InvalidWisdom};
+
+#[cfg(feature = "std")]
+type Work<T> = work::PooledWork<T>;
+
+#[cfg(all(not(feature = "std"), feature = "alloc"))]
+type Work<T> = AlignedVec<num_complex::Complex<T>>;
+
+/// The storage used for twiddle factors.
+#[cfg(any(feature = "std", feature = "alloc"))]
+type Twiddles<T> = AlignedVec<num_complex::Complex<T>>;
+
+/// Estimates the relative cost of a Stockham autosort FFT, `size * log2(size)`.
+#[cfg(any(feature = "std", feature = "alloc"))]
+fn autosort_cost(size: usize) -> usize {
+    size * (0usize.leading_zeros() - size.leading_zeros()) as usize
+}
+
+/// Estimates the relative cost of a complex FFT.
+#[cfg(any(feature = "std", feature = "alloc"))]
+fn estimate_cost(size: usize) -> usize {
+    if fourier_algorithms::is_autosort_size(size) {
+        autosort_cost(size)
+    } else if prefer_raders(size) {
+        2 * estimate_cost(size - 1) + 2 * size
+    } else {
+        2 * autosort_cost(fourier_algorithms::bluesteins_inner_size(size)) + 3 * size
+    }
+}
+
+/// Returns true if Rader's algorithm is expected to be faster than Bluestein's algorithm.
+///
+/// Rader's algorithm performs two FFTs of size `size - 1`, while Bluestein's algorithm performs two
+/// FFTs of a `2^a * 3^b` size of at least `2 * size - 1`.  Rader's algorithm is only faster when
+/// `size - 1` is itself inexpensive.
+#[cfg(any(feature = "std", feature = "alloc"))]
+fn prefer_raders(size: usize) -> bool {
+    fourier_algorithms::is_prime(size)
+        && 2 * estimate_cost(size - 1)
+            < 2 * autosort_cost(fourier_algorithms::bluesteins_inner_size(size)) + size
+}
+
 /// Create a complex-valued FFT over `f32` with the specified size.
 ///
 /// Requires the `std` or `alloc` feature.
 #[cfg(any(feature = "std", feature = "alloc"))]
-pub fn create_fft_f32(size: usize) -> Box<dyn Fft<Real = f32> + Send> {
-    use fourier_algorithms::{Autosort, Bluesteins};
-    use num_complex::Complex;
-    type Autosort32 = Autosort<f32, Vec<Complex<f32>>, Vec<Complex<f32>>>;
-    type Bluesteins32 =
-        Bluesteins<f32, Autosort32, Vec<Complex<f32>>, Vec<Complex<f32>>, Vec<Complex<f32>>>;
+pub fn create_fft_f32(size: usize) -> Box<dyn Fft<Real = f32> + Send + Sync> {
+    use fourier_algorithms::{Autosort, Bluesteins, FourStep, Raders, FOUR_STEP_MIN_SIZE};
+    type Autosort32 = Autosort<f32, Twiddles<f32>, Work<f32>>;
+    type FourStep32 = FourStep<f32, Autosort32, Twiddles<f32>, Work<f32>>;
+    type Bluesteins32 = Bluesteins<f32, Autosort32, Twiddles<f32>, Twiddles<f32>, Work<f32>>;
+    type Raders32 =
+        Raders<f32, Box<dyn Fft<Real = f32> + Send + Sync>, Twiddles<f32>, Vec<usize>, Work<f32>>;
+
+    #[cfg(feature = "std")]
+    {
+        if let Some(fft) = planner::wisdom_fft_f32(size) {
+            return fft;
+        }
+    }
 
+    if size >= FOUR_STEP_MIN_SIZE {
+        if let Some(fft) = FourStep32::new_with_fft(size, |size| Autosort32::new(size).unwrap()) {
+            return Box::new(fft);
+        }
+    }
     if let Some(fft) = Autosort32::new(size) {
         Box::new(fft)
+    } else if prefer_raders(size) {
+        Box::new(Raders32::new_with_fft(size, create_fft_f32).unwrap())
     } else {
         Box::new(Bluesteins32::new(size))
     }
@@ -46,15 +179,174 @@ pub fn create_fft_f32(size: usize) -> Box<dyn Fft<Real = f32> + Send> {
 ///
 /// Requires the `std` or `alloc` feature.
 #[cfg(any(feature = "std", feature = "alloc"))]
-pub fn create_fft_f64(size: usize) -> Box<dyn Fft<Real = f64> + Send> {
-    use fourier_algorithms::{Autosort, Bluesteins};
-    use num_complex::Complex;
-    type Autosort64 = Autosort<f64, Vec<Complex<f64>>, Vec<Complex<f64>>>;
-    type Bluesteins64 =
-        Bluesteins<f64, Autosort64, Vec<Complex<f64>>, Vec<Complex<f64>>, Vec<Complex<f64>>>;
+pub fn create_fft_f64(size: usize) -> Box<dyn Fft<Real = f64> + Send + Sync> {
+    use fourier_algorithms::{Autosort, Bluesteins, FourStep, Raders, FOUR_STEP_MIN_SIZE};
+    type Autosort64 = Autosort<f64, Twiddles<f64>, Work<f64>>;
+    type FourStep64 = FourStep<f64, Autosort64, Twiddles<f64>, Work<f64>>;
+    type Bluesteins64 = Bluesteins<f64, Autosort64, Twiddles<f64>, Twiddles<f64>, Work<f64>>;
+    type Raders64 =
+        Raders<f64, Box<dyn Fft<Real = f64> + Send + Sync>, Twiddles<f64>, Vec<usize>, Work<f64>>;
+
+    #[cfg(feature = "std")]
+    {
+        if let Some(fft) = planner::wisdom_fft_f64(size) {
+            return fft;
+        }
+    }
+    if size >= FOUR_STEP_MIN_SIZE {
+        if let Some(fft) = FourStep64::new_with_fft(size, |size| Autosort64::new(size).unwrap()) {
+            return Box::new(fft);
+        }
+    }
     if let Some(fft) = Autosort64::new(size) {
         Box::new(fft)
+    } else if prefer_raders(size) {
+        Box::new(Raders64::new_with_fft(size, create_fft_f64).unwrap())
     } else {
         Box::new(Bluesteins64::new(size))
     }
 }
+
+/// Create a complex-valued FFT over `f32` with the specified size, using compact twiddle
+/// tables.
+///
+/// Auto-sort stages store roughly `2 * sqrt(size)` twiddles per stage, rather than one per
+/// element, and reconstruct the rest within the kernels.  This reduces the memory used by large
+/// FFTs at some cost in speed.  The four-step algorithm is never used, and imported wisdom is
+/// ignored.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_compact_fft_f32(size: usize) -> Box<dyn Fft<Real = f32> + Send + Sync> {
+    use fourier_algorithms::{Autosort, Bluesteins, Raders};
+    type Autosort32 = Autosort<f32, Twiddles<f32>, Work<f32>>;
+    type Bluesteins32 = Bluesteins<f32, Autosort32, Twiddles<f32>, Twiddles<f32>, Work<f32>>;
+    type Raders32 =
+        Raders<f32, Box<dyn Fft<Real = f32> + Send + Sync>, Twiddles<f32>, Vec<usize>, Work<f32>>;
+
+    if let Some(fft) = Autosort32::new_compact(size) {
+        Box::new(fft)
+    } else if prefer_raders(size) {
+        Box::new(Raders32::new_with_fft(size, create_compact_fft_f32).unwrap())
+    } else {
+        Box::new(Bluesteins32::new_with_fft(size, |size| {
+            Autosort32::new_compact(size).unwrap()
+        }))
+    }
+}
+
+/// Create a complex-valued FFT over `f64` with the specified size, using compact twiddle
+/// tables.
+///
+/// Auto-sort stages store roughly `2 * sqrt(size)` twiddles per stage, rather than one per
+/// element, and reconstruct the rest within the kernels.  This reduces the memory used by large
+/// FFTs at some cost in speed.  The four-step algorithm is never used, and imported wisdom is
+/// ignored.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_compact_fft_f64(size: usize) -> Box<dyn Fft<Real = f64> + Send + Sync> {
+    use fourier_algorithms::{Autosort, Bluesteins, Raders};
+    type Autosort64 = Autosort<f64, Twiddles<f64>, Work<f64>>;
+    type Bluesteins64 = Bluesteins<f64, Autosort64, Twiddles<f64>, Twiddles<f64>, Work<f64>>;
+    type Raders64 =
+        Raders<f64, Box<dyn Fft<Real = f64> + Send + Sync>, Twiddles<f64>, Vec<usize>, Work<f64>>;
+
+    if let Some(fft) = Autosort64::new_compact(size) {
+        Box::new(fft)
+    } else if prefer_raders(size) {
+        Box::new(Raders64::new_with_fft(size, create_compact_fft_f64).unwrap())
+    } else {
+        Box::new(Bluesteins64::new_with_fft(size, |size| {
+            Autosort64::new_compact(size).unwrap()
+        }))
+    }
+}
+
+/// Create a complex-valued FFT over `f32` with the specified size, choosing the algorithm with
+/// the specified planner.
+///
+/// Requires the `std` feature.
+#[cfg(feature = "std")]
+pub fn create_fft_f32_with_planner(
+    size: usize,
+    planner: Planner,
+) -> Box<dyn Fft<Real = f32> + Send + Sync> {
+    match planner {
+        Planner::Estimate => create_fft_f32(size),
+        Planner::Measure => planner::measure_fft_f32(size),
+    }
+}
+
+/// Create a complex-valued FFT over `f64` with the specified size, choosing the algorithm with
+/// the specified planner.
+///
+/// Requires the `std` feature.
+#[cfg(feature = "std")]
+pub fn create_fft_f64_with_planner(
+    size: usize,
+    planner: Planner,
+) -> Box<dyn Fft<Real = f64> + Send + Sync> {
+    match planner {
+        Planner::Estimate => create_fft_f64(size),
+        Planner::Measure => planner::measure_fft_f64(size),
+    }
+}
+
+/// Create a multidimensional complex-valued FFT over `f32` with the specified dimensions.
+///
+/// The data is stored in row-major order, with the last dimension contiguous.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_multi_fft_f32(dimensions: &[usize]) -> Box<dyn Fft<Real = f32> + Send + Sync> {
+    use fourier_algorithms::MultiDimensional;
+    type Inner32 = Box<dyn Fft<Real = f32> + Send + Sync>;
+    type Multi32 = MultiDimensional<f32, Inner32, Vec<Inner32>, Work<f32>>;
+    Box::new(Multi32::new(
+        dimensions
+            .iter()
+            .map(|size| create_fft_f32(*size))
+            .collect(),
+    ))
+}
+
+/// Create a multidimensional complex-valued FFT over `f64` with the specified dimensions.
+///
+/// The data is stored in row-major order, with the last dimension contiguous.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_multi_fft_f64(dimensions: &[usize]) -> Box<dyn Fft<Real = f64> + Send + Sync> {
+    use fourier_algorithms::MultiDimensional;
+    type Inner64 = Box<dyn Fft<Real = f64> + Send + Sync>;
+    type Multi64 = MultiDimensional<f64, Inner64, Vec<Inner64>, Work<f64>>;
+    Box::new(Multi64::new(
+        dimensions
+            .iter()
+            .map(|size| create_fft_f64(*size))
+            .collect(),
+    ))
+}
+
+/// Create a real-valued FFT over `f32` with the specified size.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_real_fft_f32(size: usize) -> Box<dyn RealFft<Real = f32> + Send + Sync> {
+    use fourier_algorithms::PackedRealFft;
+    type Real32 =
+        PackedRealFft<f32, Box<dyn Fft<Real = f32> + Send + Sync>, Twiddles<f32>, Work<f32>>;
+    Box::new(Real32::new_with_fft(size, create_fft_f32))
+}
+
+/// Create a real-valued FFT over `f64` with the specified size.
+///
+/// Requires the `std` or `alloc` feature.
+#[cfg(any(feature = "std", feature = "alloc"))]
+pub fn create_real_fft_f64(size: usize) -> Box<dyn RealFft<Real = f64> + Send + Sync> {
+    use fourier_algorithms::PackedRealFft;
+    type Real64 =
+        PackedRealFft<f64, Box<dyn Fft<Real = f64> + Send + Sync>, Twiddles<f64>, Work<f64>>;
+    Box::new(Real64::new_with_fft(size, create_fft_f64))
+}
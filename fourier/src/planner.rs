@@ -0,0 +1,146 @@
+//! Planning FFTs by measuring candidate algorithms.
+
+use crate::wisdom::{self, Algorithm};
+use crate::{Fft, Transform, Twiddles, Work};
+use fourier_algorithms::{
+    autosort_factorizations, is_autosort_size, is_prime, Autosort, Bluesteins, FftFloat, FourStep,
+    Raders,
+};
+use num_complex::Complex;
+use std::time::{Duration, Instant};
+
+/// Strategies for choosing the algorithm used by an FFT.
+#[derive(Copy, Clone, PartialEq, Eq, Debug)]
+pub enum Planner {
+    /// Choose an algorithm with a cost estimate.  This is the strategy used by [`create_fft_f32`]
+    /// and [`create_fft_f64`].
+    ///
+    /// [`create_fft_f32`]: fn.create_fft_f32.html
+    /// [`create_fft_f64`]: fn.create_fft_f64.html
+    Estimate,
+    /// Time the candidate algorithms and autosort factorizations on this machine, and keep the
+    /// fastest.  Planning typically takes many times longer than a single transform.
+    Measure,
+}
+
+/// The minimum duration of each measurement.
+const MIN_MEASUREMENT: Duration = Duration::from_millis(1);
+
+/// The number of measurements of each candidate.  The fastest measurement is kept.
+const MEASUREMENTS: usize = 3;
+
+/// Returns the time taken by a single transform.
+fn measure<T: FftFloat>(fft: &dyn Fft<Real = T>) -> Duration {
+    let mut input = vec![Complex::<T>::default(); fft.size()];
+    let mut scratch = vec![Complex::<T>::default(); fft.scratch_size()];
+    let mut run = |iterations: u32| {
+        let start = Instant::now();
+        for _ in 0..iterations {
+            fft.transform_in_place_with_scratch(&mut input, &mut scratch, Transform::Fft);
+        }
+        start.elapsed()
+    };
+
+    // Increase the iterations until a measurement is long enough to be reliable
+    let mut iterations = 1;
+    while run(iterations) < MIN_MEASUREMENT {
+        iterations *= 2;
+    }
+    (0..MEASUREMENTS).map(|_| run(iterations)).min().unwrap() / iterations
+}
+
+/// Returns the fastest candidate.
+fn fastest<T: FftFloat>(
+    candidates: Vec<(Algorithm, Box<dyn Fft<Real = T> + Send + Sync>)>,
+) -> (Algorithm, Box<dyn Fft<Real = T> + Send + Sync>) {
+    candidates
+        .into_iter()
+        .map(|(algorithm, fft)| (measure(&*fft), algorithm, fft))
+        .min_by_key(|(time, _, _)| *time)
+        .map(|(_, algorithm, fft)| (algorithm, fft))
+        .unwrap()
+}
+
+macro_rules! implement {
+    {
+        $type:ty, $measure:ident, $wisdom:ident, $create:ident
+    } => {
+        /// Create an FFT with the recorded decision for the specified size, if there is one.
+        pub(crate) fn $wisdom(size: usize) -> Option<Box<dyn Fft<Real = $type> + Send + Sync>> {
+            type AutosortT = Autosort<$type, Twiddles<$type>, Work<$type>>;
+            type FourStepT = FourStep<$type, AutosortT, Twiddles<$type>, Work<$type>>;
+            type BluesteinsT =
+                Bluesteins<$type, AutosortT, Twiddles<$type>, Twiddles<$type>, Work<$type>>;
+            type RadersT = Raders<
+                $type,
+                Box<dyn Fft<Real = $type> + Send + Sync>,
+                Twiddles<$type>,
+                Vec<usize>,
+                Work<$type>,
+            >;
+
+            // Imported wisdom may not be valid for this size
+            Some(match wisdom::lookup::<$type>(size)? {
+                Algorithm::Autosort(counts, generic_radices) => {
+                    Box::new(AutosortT::new_with_factors(size, counts, generic_radices)?)
+                }
+                Algorithm::FourStep => Box::new(FourStepT::new_with_fft(size, |size| {
+                    AutosortT::new(size).unwrap()
+                })?),
+                Algorithm::Raders => Box::new(RadersT::new_with_fft(size, crate::$create)?),
+                Algorithm::Bluesteins => Box::new(BluesteinsT::new(size)),
+            })
+        }
+
+        /// Measures every candidate algorithm for the specified size and returns the fastest.
+        ///
+        /// The decision is recorded, and recorded decisions are used in place of measuring.
+        pub(crate) fn $measure(size: usize) -> Box<dyn Fft<Real = $type> + Send + Sync> {
+            type AutosortT = Autosort<$type, Twiddles<$type>, Work<$type>>;
+            type FourStepT = FourStep<$type, AutosortT, Twiddles<$type>, Work<$type>>;
+            type BluesteinsT =
+                Bluesteins<$type, AutosortT, Twiddles<$type>, Twiddles<$type>, Work<$type>>;
+            type RadersT = Raders<
+                $type,
+                Box<dyn Fft<Real = $type> + Send + Sync>,
+                Twiddles<$type>,
+                Vec<usize>,
+                Work<$type>,
+            >;
+
+            if let Some(fft) = $wisdom(size) {
+                return fft;
+            }
+
+            let mut candidates: Vec<(Algorithm, Box<dyn Fft<Real = $type> + Send + Sync>)> =
+                Vec::new();
+            let mut generic = false;
+            for (counts, generic_radices) in autosort_factorizations(size) {
+                generic = generic_radices[0] != 0;
+                candidates.push((
+                    Algorithm::Autosort(counts, generic_radices),
+                    Box::new(AutosortT::new_with_factors(size, counts, generic_radices).unwrap()),
+                ));
+            }
+            if let Some(fft) = FourStepT::new_with_fft(size, |size| AutosortT::new(size).unwrap()) {
+                candidates.push((Algorithm::FourStep, Box::new(fft)));
+            }
+
+            // Generic radix stages may be slower than the alternatives for large radices
+            if generic || !is_autosort_size(size) {
+                if is_prime(size) {
+                    candidates.push((
+                        Algorithm::Raders,
+                        Box::new(RadersT::new_with_fft(size, $measure).unwrap()),
+                    ));
+                }
+                candidates.push((Algorithm::Bluesteins, Box::new(BluesteinsT::new(size))));
+            }
+            let (algorithm, fft) = fastest(candidates);
+            wisdom::record::<$type>(size, algorithm);
+            fft
+        }
+    }
+}
+implement! { f32, measure_fft_f32, wisdom_fft_f32, create_fft_f32 }
+implement! { f64, measure_fft_f64, wisdom_fft_f64, create_fft_f64 }
@@ -0,0 +1,208 @@
+//! Recording planning decisions, so they can be reused by later plans and other processes.
+
+use crate::global::Global;
+use fourier_algorithms::{MAX_GENERIC_STAGES, NUM_RADICES};
+use std::collections::BTreeMap;
+use std::sync::Mutex;
+
+/// The first bytes of exported wisdom.
+const MAGIC: &[u8] = b"fourierw";
+
+/// The version of the wisdom format.
+const VERSION: u8 = 1;
+
+/// The algorithm chosen for an FFT.
+///
+/// The decisions of any inner FFTs (such as the FFT of size `size - 1` used by Rader's algorithm)
+/// are recorded separately under their own size.
+#[derive(Copy, Clone, PartialEq, Eq, Debug)]
+pub(crate) enum Algorithm {
+    /// An autosort FFT with the specified radix counts and generic radices.
+    Autosort([usize; NUM_RADICES], [usize; MAX_GENERIC_STAGES]),
+    /// A four-step FFT with the default factors.
+    FourStep,
+    /// Rader's algorithm.
+    Raders,
+    /// Bluestein's algorithm.
+    Bluesteins,
+}
+
+/// Identifies a planning decision.  Decisions are only reused by machines with the same CPU
+/// features, since the fastest kernels depend on the available instruction sets.
+#[derive(Copy, Clone, PartialEq, Eq, PartialOrd, Ord, Debug)]
+struct Key {
+    features: u8,
+    precision: u8,
+    size: u64,
+}
+
+static WISDOM: Global<Mutex<BTreeMap<Key, Algorithm>>> = Global::new();
+
+fn wisdom() -> &'static Mutex<BTreeMap<Key, Algorithm>> {
+    WISDOM.get(|| Mutex::new(BTreeMap::new()))
+}
+
+/// Returns the CPU features that select between kernels, as a bit mask.
+fn cpu_features() -> u8 {
+    #[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
+    {
+        let mut features = 0;
+        if is_x86_feature_detected!("sse3") {
+            features |= 1;
+        }
+        if is_x86_feature_detected!("avx") {
+            features |= 2;
+        }
+        if is_x86_feature_detected!("avx2") && is_x86_feature_detected!("fma") {
+            features |= 4;
+        }
+        #[cfg(feature = "avx512")]
+        {
+            if is_x86_feature_detected!("avx512f") {
+                features |= 8;
+            }
+        }
+        features
+    }
+    #[cfg(not(any(target_arch = "x86", target_arch = "x86_64")))]
+    {
+        0
+    }
+}
+
+fn key<T>(size: usize) -> Key {
+    Key {
+        features: cpu_features(),
+        precision: core::mem::size_of::<T>() as u8,
+        size: size as u64,
+    }
+}
+
+/// Returns the recorded decision for an FFT of the specified size and precision on this machine.
+pub(crate) fn lookup<T>(size: usize) -> Option<Algorithm> {
+    wisdom().lock().unwrap().get(&key::<T>(size)).copied()
+}
+
+/// Records the decision for an FFT of the specified size and precision on this machine.
+pub(crate) fn record<T>(size: usize, algorithm: Algorithm) {
+    wisdom().lock().unwrap().insert(key::<T>(size), algorithm);
+}
+
+/// The error returned when importing invalid wisdom.
+#[derive(Copy, Clone, PartialEq, Eq, Debug)]
+pub struct InvalidWisdom;
+
+impl core::fmt::Display for InvalidWisdom {
+    fn fmt(&self, f: &mut core::fmt::Formatter) -> core::fmt::Result {
+        f.write_str("invalid FFT wisdom")
+    }
+}
+
+impl std::error::Error for InvalidWisdom {}
+
+/// Export the planning decisions made by [`Planner::Measure`] in this process.
+///
+/// The decisions are recorded in a compact binary format, keyed by FFT size, precision, and the
+/// CPU features of the machine.  Importing them with [`import_wisdom`] lets later processes skip
+/// measurement for FFTs that have already been planned.
+///
+/// [`Planner::Measure`]: enum.Planner.html#variant.Measure
+/// [`import_wisdom`]: fn.import_wisdom.html
+pub fn export_wisdom() -> Vec<u8> {
+    let wisdom = wisdom().lock().unwrap();
+    let mut bytes = MAGIC.to_vec();
+    bytes.push(VERSION);
+    for (key, algorithm) in wisdom.iter() {
+        bytes.push(key.features);
+        bytes.push(key.precision);
+        bytes.extend_from_slice(&key.size.to_le_bytes());
+        match algorithm {
+            Algorithm::Autosort(counts, generic_radices) => {
+                bytes.push(0);
+                bytes.extend(counts.iter().map(|count| *count as u8));
+                let generic_radices = generic_radices.iter().take_while(|radix| **radix != 0);
+                bytes.push(generic_radices.clone().count() as u8);
+                bytes.extend(generic_radices.map(|radix| *radix as u8));
+            }
+            Algorithm::FourStep => bytes.push(1),
+            Algorithm::Raders => bytes.push(2),
+            Algorithm::Bluesteins => bytes.push(3),
+        }
+    }
+    bytes
+}
+
+/// Reads the entries of exported wisdom.
+fn parse(mut bytes: &[u8]) -> Option<Vec<(Key, Algorithm)>> {
+    fn take<'a>(bytes: &mut &'a [u8], count: usize) -> Option<&'a [u8]> {
+        if bytes.len() < count {
+            return None;
+        }
+        let (taken, rest) = bytes.split_at(count);
+        *bytes = rest;
+        Some(taken)
+    }
+
+    if take(&mut bytes, MAGIC.len())? != MAGIC || take(&mut bytes, 1)? != [VERSION] {
+        return None;
+    }
+    let mut entries = Vec::new();
+    while !bytes.is_empty() {
+        let header = take(&mut bytes, 10)?;
+        let mut size = [0; 8];
+        size.copy_from_slice(&header[2..]);
+        let key = Key {
+            features: header[0],
+            precision: header[1],
+            size: u64::from_le_bytes(size),
+        };
+        if key.precision != 4 && key.precision != 8 {
+            return None;
+        }
+        let algorithm = match take(&mut bytes, 1)?[0] {
+            0 => {
+                let mut counts = [0; NUM_RADICES];
+                for (count, byte) in counts.iter_mut().zip(take(&mut bytes, NUM_RADICES)?) {
+                    *count = *byte as usize;
+                }
+                let stages = take(&mut bytes, 1)?[0] as usize;
+                if stages > MAX_GENERIC_STAGES {
+                    return None;
+                }
+                let mut generic_radices = [0; MAX_GENERIC_STAGES];
+                for (radix, byte) in generic_radices.iter_mut().zip(take(&mut bytes, stages)?) {
+                    *radix = *byte as usize;
+                }
+                Algorithm::Autosort(counts, generic_radices)
+            }
+            1 => Algorithm::FourStep,
+            2 => Algorithm::Raders,
+            3 => Algorithm::Bluesteins,
+            _ => return None,
+        };
+        entries.push((key, algorithm));
+    }
+    Some(entries)
+}
+
+/// Import planning decisions exported by [`export_wisdom`].
+///
+/// Imported decisions are used by every planner, including [`create_fft_f32`] and
+/// [`create_fft_f64`], in place of estimating or measuring.  Decisions made on machines with
+/// different CPU features are kept (and exported again) but not used.  Decisions that are not
+/// valid for their size are ignored when planning.  If the wisdom is malformed, nothing is
+/// imported.
+///
+/// [`export_wisdom`]: fn.export_wisdom.html
+/// [`create_fft_f32`]: fn.create_fft_f32.html
+/// [`create_fft_f64`]: fn.create_fft_f64.html
+pub fn import_wisdom(bytes: &[u8]) -> Result<(), InvalidWisdom> {
+    let entries = parse(bytes).ok_or(InvalidWisdom)?;
+    wisdom().lock().unwrap().extend(entries);
+    Ok(())
+}
+
+/// Forget all planning decisions, whether measured or imported.
+pub fn forget_wisdom() {
+    wisdom().lock().unwrap().clear();
+}
@@ -0,0 +1,95 @@
+//! Thread-local work buffer pools.
+//!
+//! Transforms allocate a work buffer every time they are applied.  Rather than hitting the heap
+//! allocator on every transform, buffers are taken from a per-thread pool and returned when the
+//! transform completes.  Each pool holds a stack of buffers so nested transforms (such as the
+//! inner FFT of Bluestein's algorithm) each receive their own buffer.
+//!
+//! Pooled buffers stay allocated for the lifetime of the thread, so the pools are bounded: each
+//! pool keeps at most `MAX_POOLED_BUFFERS` buffers, and buffers larger than
+//! `MAX_POOLED_BYTES` are freed rather than returned to the pool.  Very large transforms
+//! therefore allocate their work buffers every time, which is cheap relative to the transform.
+
+use crate::AlignedVec;
+use core::cell::RefCell;
+use num_complex::Complex;
+
+/// The maximum number of buffers kept in each thread's pool.  This covers the deepest nesting of
+/// inner FFTs.
+const MAX_POOLED_BUFFERS: usize = 8;
+
+/// The maximum size of a buffer kept in a pool, in bytes.
+const MAX_POOLED_BYTES: usize = 16 << 20;
+
+/// Types with a thread-local work buffer pool.
+pub trait Pooled: Copy {
+    /// Take a buffer from the pool, or an empty buffer if the pool is empty.
+    fn take() -> AlignedVec<Complex<Self>>;
+
+    /// Return a buffer to the pool.  If the pool is full or the buffer is too large, the buffer is
+    /// freed.
+    fn give(buffer: AlignedVec<Complex<Self>>);
+}
+
+macro_rules! implement {
+    {
+        $type:ty, $pool:ident
+    } => {
+        thread_local! {
+            static $pool: RefCell<Vec<AlignedVec<Complex<$type>>>> = RefCell::new(Vec::new());
+        }
+
+        impl Pooled for $type {
+            fn take() -> AlignedVec<Complex<$type>> {
+                $pool
+                    .try_with(|pool| pool.borrow_mut().pop())
+                    .ok()
+                    .and_then(|buffer| buffer)
+                    .unwrap_or_default()
+            }
+
+            fn give(buffer: AlignedVec<Complex<$type>>) {
+                if buffer.capacity() * core::mem::size_of::<Complex<$type>>() > MAX_POOLED_BYTES {
+                    return;
+                }
+
+                // If the thread is being torn down, the buffer is simply dropped.
+                let _ = $pool.try_with(|pool| {
+                    let mut pool = pool.borrow_mut();
+                    if pool.len() < MAX_POOLED_BUFFERS {
+                        pool.push(buffer);
+                    }
+                });
+            }
+        }
+    }
+}
+implement! { f32, POOL_F32 }
+implement! { f64, POOL_F64 }
+
+/// A work buffer borrowed from the current thread's pool.
+pub struct PooledWork<T: Pooled>(AlignedVec<Complex<T>>);
+
+impl<T: Pooled> Default for PooledWork<T> {
+    fn default() -> Self {
+        Self(T::take())
+    }
+}
+
+impl<T: Pooled> Drop for PooledWork<T> {
+    fn drop(&mut self) {
+        T::give(core::mem::replace(&mut self.0, AlignedVec::new()));
+    }
+}
+
+impl<T: Pooled> Extend<Complex<T>> for PooledWork<T> {
+    fn extend<I: IntoIterator<Item = Complex<T>>>(&mut self, iter: I) {
+        self.0.extend(iter);
+    }
+}
+
+impl<T: Pooled> AsMut<[Complex<T>]> for PooledWork<T> {
+    fn as_mut(&mut self) -> &mut [Complex<T>] {
+        &mut self.0
+    }
+}
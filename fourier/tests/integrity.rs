@@ -1,3 +1,4 @@
+use fourier::RealFft;
 use num_complex::Complex;
 use num_traits::{Float, FromPrimitive, NumAssign};
 use rand::{rngs::StdRng, Rng, SeedableRng};
@@ -11,7 +12,8 @@ fn dft<T: FromPrimitive + Float + NumAssign + Default + Clone>(
     for k in 0..input.len() {
         output[k] = Complex::default();
         for n in 0..input.len() {
-            let f = std::f64::consts::PI * ((2 * k * n) as f64) / (input.len() as f64);
+            let f = std::f64::consts::PI * ((2 * k * n % (2 * input.len())) as f64)
+                / (input.len() as f64);
             output[k] += input[n]
                 * Complex::new(
                     T::from_f64(f.cos()).unwrap(),
@@ -29,7 +31,8 @@ fn idft<T: FromPrimitive + Float + NumAssign + Default + Clone>(
     for k in 0..input.len() {
         output[k] = Complex::default();
         for n in 0..input.len() {
-            let f = std::f64::consts::PI * ((2 * k * n) as f64) / (input.len() as f64);
+            let f = std::f64::consts::PI * ((2 * k * n % (2 * input.len())) as f64)
+                / (input.len() as f64);
             output[k] += input[n]
                 * Complex::new(
                     T::from_f64(f.cos() / (input.len() as f64)).unwrap(),
@@ -252,3 +255,680 @@ generate_static_test! { f32, StaticFft73f32, integrity_static_f32_73_inverse, ne
 struct StaticFft73f64;
 generate_static_test! { f64, StaticFft73f64, integrity_static_f64_73_forward, near_f64, true }
 generate_static_test! { f64, StaticFft73f64, integrity_static_f64_73_inverse, near_f64, false }
+
+#[fourier::static_fft(f32, 70)]
+struct StaticFft70f32;
+generate_static_test! { f32, StaticFft70f32, integrity_static_f32_70_forward, near_f32, true }
+generate_static_test! { f32, StaticFft70f32, integrity_static_f32_70_inverse, near_f32, false }
+
+#[fourier::static_fft(f64, 88)]
+struct StaticFft88f64;
+generate_static_test! { f64, StaticFft88f64, integrity_static_f64_88_forward, near_f64, true }
+generate_static_test! { f64, StaticFft88f64, integrity_static_f64_88_inverse, near_f64, false }
+
+// An FFT implementing only the required methods, as a downstream implementor might
+struct NaiveDft(usize);
+
+impl fourier::Fft for NaiveDft {
+    type Real = f64;
+
+    fn size(&self) -> usize {
+        self.0
+    }
+
+    fn transform_in_place(&self, input: &mut [Complex<f64>], transform: fourier::Transform) {
+        assert!(transform == fourier::Transform::Fft);
+        let copy = input.to_vec();
+        dft(&copy, input);
+    }
+}
+
+#[test]
+fn default_scratch() {
+    use fourier::Fft;
+    let fft = NaiveDft(10);
+    assert_eq!(fft.scratch_size(), 0);
+    let input = (0..10)
+        .map(|i| Complex::new(i as f64, 0.0))
+        .collect::<Vec<_>>();
+    let mut expected = vec![Complex::default(); 10];
+    dft(&input, &mut expected);
+    let mut actual = input.clone();
+    fft.transform_in_place_with_scratch(&mut actual, &mut [], fourier::Transform::Fft);
+    assert_eq!(actual, expected);
+    let mut actual = vec![Complex::default(); 10];
+    fft.transform_with_scratch(&input, &mut actual, &mut [], fourier::Transform::Fft);
+    assert_eq!(actual, expected);
+
+    // Two interleaved vectors
+    let mut batch = input
+        .iter()
+        .flat_map(|x| vec![*x, *x * 2.0])
+        .collect::<Vec<_>>();
+    fft.transform_batch_in_place(&mut batch, 2, 2, 1, fourier::Transform::Fft);
+    for (i, x) in batch.iter().enumerate() {
+        let scale = if i % 2 == 0 { 1.0 } else { 2.0 };
+        assert!((x - expected[i / 2] * scale).norm() < 1e-10);
+    }
+
+    let mut real = input.iter().map(|x| x.re).collect::<Vec<_>>();
+    let mut imag = input.iter().map(|x| x.im).collect::<Vec<_>>();
+    fft.transform_split_in_place(&mut real, &mut imag, fourier::Transform::Fft);
+    for ((re, im), x) in real.iter().zip(imag.iter()).zip(expected.iter()) {
+        assert_eq!(Complex::new(*re, *im), *x);
+    }
+}
+
+macro_rules! generate_concurrent_test {
+    {
+        $type:ty, $name:ident, $fft_gen:ident
+    } => {
+        #[cfg(feature = "std")]
+        #[test]
+        fn $name() {
+            const THREADS: usize = 8;
+            // Autosort and Bluestein's algorithm
+            for &size in &[96, 97] {
+                let distribution = Normal::new(0.0, 1.0).unwrap();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                let fft = std::sync::Arc::new(fourier::$fft_gen(size));
+                let mut expected = vec![Complex::default(); size];
+                fft.fft(&input, &mut expected);
+
+                let input = std::sync::Arc::new(input);
+                let threads = (0..THREADS)
+                    .map(|_| {
+                        let fft = fft.clone();
+                        let input = input.clone();
+                        std::thread::spawn(move || {
+                            let mut output = vec![Complex::default(); size];
+                            for _ in 0..100 {
+                                fft.fft(&input, &mut output);
+                            }
+                            output
+                        })
+                    })
+                    .collect::<Vec<_>>();
+                for thread in threads {
+                    assert_eq!(thread.join().unwrap(), expected);
+                }
+            }
+        }
+    }
+}
+
+generate_concurrent_test! { f32, concurrent_f32, create_fft_f32 }
+generate_concurrent_test! { f64, concurrent_f64, create_fft_f64 }
+
+macro_rules! generate_scratch_test {
+    {
+        $type:ty, $name:ident, $fft_gen:ident, $comparison:ident
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        #[test]
+        fn $name() {
+            const MAX_SIZE: usize = 256;
+            let distribution = Normal::new(0.0, 1.0).unwrap();
+            let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+            let input = rng
+                .sample_iter(&distribution)
+                .zip(rand::thread_rng().sample_iter(&distribution))
+                .take(MAX_SIZE)
+                .map(|(x, y)| Complex::new(x, y))
+                .collect::<Vec<_>>();
+            let mut expected = vec![Complex::default(); MAX_SIZE];
+            let mut actual = vec![Complex::default(); MAX_SIZE];
+
+            // A single scratch buffer is shared by every size
+            let mut scratch = Vec::new();
+            for size in 1..MAX_SIZE {
+                let fft = fourier::$fft_gen(size);
+                if scratch.len() < fft.scratch_size() {
+                    scratch.resize(fft.scratch_size(), Complex::new(<$type>::NAN, <$type>::NAN));
+                }
+                fft.fft(&input[0..size], &mut expected[0..size]);
+                fft.transform_with_scratch(
+                    &input[0..size],
+                    &mut actual[0..size],
+                    &mut scratch,
+                    fourier::Transform::Fft,
+                );
+                assert_eq!(&actual[0..size], &expected[0..size]);
+
+                // In-place transforms match out-of-place transforms
+                actual[0..size].copy_from_slice(&input[0..size]);
+                fft.transform_in_place_with_scratch(
+                    &mut actual[0..size],
+                    &mut scratch,
+                    fourier::Transform::Fft,
+                );
+                $comparison(&actual[0..size], &expected[0..size]);
+            }
+        }
+    }
+}
+
+generate_scratch_test! { f32, scratch_f32, create_fft_f32, near_f32 }
+generate_scratch_test! { f64, scratch_f64, create_fft_f64, near_f64 }
+
+macro_rules! generate_batch_test {
+    {
+        $type:ty, $name:ident, $fft_gen:ident
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        #[test]
+        fn $name() {
+            const COUNT: usize = 5;
+            // Autosort and Bluestein's algorithm
+            for &size in &[96, 97] {
+                let fft = fourier::$fft_gen(size);
+                // Contiguous with padding between vectors, and interleaved
+                for &(stride, distance) in &[(1, size + 3), (COUNT, 1)] {
+                    let len = (COUNT - 1) * distance + (size - 1) * stride + 1;
+                    let distribution = Normal::new(0.0, 1.0).unwrap();
+                    let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                    let input = rng
+                        .sample_iter(&distribution)
+                        .zip(rand::thread_rng().sample_iter(&distribution))
+                        .take(len)
+                        .map(|(x, y)| Complex::new(x, y))
+                        .collect::<Vec<_>>();
+
+                    let mut expected = input.clone();
+                    let mut vector = vec![Complex::default(); size];
+                    for i in 0..COUNT {
+                        for j in 0..size {
+                            vector[j] = expected[i * distance + j * stride];
+                        }
+                        fft.fft_in_place(&mut vector);
+                        for j in 0..size {
+                            expected[i * distance + j * stride] = vector[j];
+                        }
+                    }
+
+                    let mut actual = input.clone();
+                    fft.transform_batch_in_place(
+                        &mut actual,
+                        COUNT,
+                        stride,
+                        distance,
+                        fourier::Transform::Fft,
+                    );
+                    assert_eq!(actual, expected);
+                }
+            }
+        }
+    }
+}
+
+generate_batch_test! { f32, batch_f32, create_fft_f32 }
+generate_batch_test! { f64, batch_f64, create_fft_f64 }
+
+macro_rules! generate_split_test {
+    {
+        $type:ty, $name:ident, $comparison:ident, $sizes:expr, $fft_gen:expr
+    } => {
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            let distribution = Normal::new(0.0, 1.0).unwrap();
+            for size in $sizes {
+                println!("SIZE: {}", size);
+                let fft = $fft_gen(size);
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                for &transform in &[fourier::Transform::Fft, fourier::Transform::Ifft] {
+                    let mut expected = input.clone();
+                    fft.transform_in_place(&mut expected, transform);
+
+                    let mut real = input.iter().map(|x| x.re).collect::<Vec<_>>();
+                    let mut imag = input.iter().map(|x| x.im).collect::<Vec<_>>();
+                    fft.transform_split_in_place(&mut real, &mut imag, transform);
+                    let actual = real
+                        .iter()
+                        .zip(imag.iter())
+                        .map(|(re, im)| Complex::new(*re, *im))
+                        .collect::<Vec<_>>();
+                    $comparison(&expected, &actual);
+
+                    let mut real = input.iter().map(|x| x.re).collect::<Vec<_>>();
+                    let mut imag = input.iter().map(|x| x.im).collect::<Vec<_>>();
+                    let mut scratch = vec![Complex::default(); fft.split_scratch_size()];
+                    fft.transform_split_in_place_with_scratch(&mut real, &mut imag, &mut scratch, transform);
+                    let actual = real
+                        .iter()
+                        .zip(imag.iter())
+                        .map(|(re, im)| Complex::new(*re, *im))
+                        .collect::<Vec<_>>();
+                    $comparison(&expected, &actual);
+                }
+            }
+        }
+    }
+}
+
+#[cfg(any(feature = "std", feature = "alloc"))]
+generate_split_test! { f32, split_f32, near_f32, (1..256).chain(vec![2816, 1013]), fourier::create_fft_f32 }
+#[cfg(any(feature = "std", feature = "alloc"))]
+generate_split_test! { f64, split_f64, near_f64, (1..256).chain(vec![2816, 1013]), fourier::create_fft_f64 }
+generate_split_test! { f32, split_static_f32_64, near_f32, Some(64), |_| StaticFft64f32::default() }
+generate_split_test! { f64, split_static_f64_73, near_f64, Some(73), |_| StaticFft73f64::default() }
+
+macro_rules! generate_real_test {
+    {
+        $type:ty, $name:ident, $comparison:ident, $sizes:expr, $fft_gen:expr
+    } => {
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            let distribution = Normal::new(0.0, 1.0).unwrap();
+            for size in $sizes {
+                println!("SIZE: {}", size);
+                let fft = $fft_gen(size);
+                assert_eq!(fft.size(), size);
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .take(size)
+                    .collect::<Vec<$type>>();
+                let complex_input = input
+                    .iter()
+                    .map(|x| Complex::new(*x, 0.0))
+                    .collect::<Vec<_>>();
+                let mut dft_output = vec![Complex::default(); size];
+                dft(&complex_input, &mut dft_output);
+
+                let mut fft_output = vec![Complex::default(); fft.complex_size()];
+                fft.fft(&input, &mut fft_output);
+                $comparison(&dft_output[..size / 2 + 1], &fft_output);
+
+                let mut ifft_output = vec![0.0; size];
+                fft.ifft(&fft_output, &mut ifft_output);
+                let ifft_output = ifft_output
+                    .iter()
+                    .map(|x| Complex::new(*x, 0.0))
+                    .collect::<Vec<_>>();
+                $comparison(&complex_input, &ifft_output);
+            }
+        }
+    }
+}
+
+#[cfg(any(feature = "std", feature = "alloc"))]
+generate_real_test! { f32, real_f32, near_f32, 1..256, fourier::create_real_fft_f32 }
+#[cfg(any(feature = "std", feature = "alloc"))]
+generate_real_test! { f64, real_f64, near_f64, 1..256, fourier::create_real_fft_f64 }
+
+#[fourier::static_fft(f32, 64, real)]
+struct StaticRealFft64f32;
+generate_real_test! { f32, real_static_f32_64, near_f32, Some(64), |_| StaticRealFft64f32::default() }
+
+#[fourier::static_fft(f64, 146, real)]
+struct StaticRealFft146f64;
+generate_real_test! { f64, real_static_f64_146, near_f64, Some(146), |_| StaticRealFft146f64::default() }
+
+#[fourier::static_fft(f64, 73, real)]
+struct StaticRealFft73f64;
+generate_real_test! { f64, real_static_f64_73, near_f64, Some(73), |_| StaticRealFft73f64::default() }
+
+/// Applies a DFT along each axis of a row-major array.
+fn dft_multi<T: FromPrimitive + Float + NumAssign + Default + Clone>(
+    dimensions: &[usize],
+    data: &mut [Complex<T>],
+) {
+    let mut stride = data.len();
+    for size in dimensions {
+        stride /= size;
+        for block in data.chunks_exact_mut(size * stride) {
+            for column in 0..stride {
+                let input = (0..*size)
+                    .map(|i| block[i * stride + column])
+                    .collect::<Vec<_>>();
+                let mut output = vec![Complex::default(); *size];
+                dft(&input, &mut output);
+                for (i, x) in output.iter().enumerate() {
+                    block[i * stride + column] = *x;
+                }
+            }
+        }
+    }
+}
+
+macro_rules! generate_multi_test {
+    {
+        $type:ty, $name:ident, $fft_gen:ident, $comparison:ident
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        #[test]
+        fn $name() {
+            let distribution = Normal::new(0.0, 1.0).unwrap();
+            let dimensions: [&[usize]; 6] = [&[6, 10], &[4, 3, 5], &[1, 7], &[7, 1], &[40, 9], &[3, 40]];
+            for dimensions in dimensions.iter() {
+                println!("DIMENSIONS: {:?}", dimensions);
+                let size = dimensions.iter().product();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                let mut dft_output = input.clone();
+                dft_multi::<$type>(dimensions, &mut dft_output);
+
+                let fft = fourier::$fft_gen(dimensions);
+                assert_eq!(fft.size(), size);
+                let mut fft_output = vec![Complex::default(); size];
+                fft.fft(&input, &mut fft_output);
+                $comparison(&dft_output, &fft_output);
+
+                fft.ifft_in_place(&mut fft_output);
+                $comparison(&input, &fft_output);
+            }
+        }
+    }
+}
+
+generate_multi_test! { f32, multi_f32, create_multi_fft_f32, near_f32 }
+generate_multi_test! { f64, multi_f64, create_multi_fft_f64, near_f64 }
+
+macro_rules! generate_large_test {
+    {
+        $type:ty, $name:ident, $fft_gen:path, $comparison:ident, $sizes:expr
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            for size in $sizes.iter().copied() {
+                println!("SIZE: {}", size);
+                // Keep the output near unit magnitude, since the tolerance is absolute
+                let distribution = Normal::new(0.0, 1.0 / (size as $type).sqrt()).unwrap();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                let mut dft_output = vec![Complex::default(); size];
+                dft::<$type>(&input, &mut dft_output);
+
+                let fft = $fft_gen(size);
+                let mut fft_output = vec![Complex::default(); size];
+                fft.fft(&input, &mut fft_output);
+                $comparison(&dft_output, &fft_output);
+
+                fft.ifft_in_place(&mut fft_output);
+                $comparison(&input, &fft_output);
+            }
+        }
+    }
+}
+
+generate_large_test! { f32, prime_f32, fourier::create_fft_f32, near_f32, [191, 211, 439, 1013] }
+generate_large_test! { f64, prime_f64, fourier::create_fft_f64, near_f64, [191, 211, 439, 1013] }
+
+// Sizes with prime factors performed by generic radix stages
+generate_large_test! { f32, generic_radix_f32, fourier::create_fft_f32, near_f32, [2816, 1352, 1292, 3904, 3721] }
+generate_large_test! { f64, generic_radix_f64, fourier::create_fft_f64, near_f64, [2816, 1352, 1292, 3904, 3721] }
+
+// The four-step algorithm is only selected for very large sizes, so test it directly
+macro_rules! generate_four_step_fn {
+    {
+        $type:ty, $name:ident
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        fn $name(size: usize) -> impl fourier::Fft<Real = $type> {
+            use fourier_algorithms::{Autosort, FourStep};
+            type Inner = Autosort<$type, Vec<Complex<$type>>, Vec<Complex<$type>>>;
+            FourStep::<$type, Inner, Vec<Complex<$type>>, Vec<Complex<$type>>>::new_with_fft(
+                size,
+                |size| Inner::new(size).unwrap(),
+            )
+            .unwrap()
+        }
+    }
+}
+generate_four_step_fn! { f32, create_four_step_f32 }
+generate_four_step_fn! { f64, create_four_step_f64 }
+generate_large_test! { f32, four_step_f32, create_four_step_f32, near_f32, [256, 1024, 2816, 3721, 4800] }
+generate_large_test! { f64, four_step_f64, create_four_step_f64, near_f64, [256, 1024, 2816, 3721, 4800] }
+
+// Bluestein's algorithm with inner sizes that aren't powers of two
+generate_large_test! { f32, bluesteins_f32, fourier::create_fft_f32, near_f32, [1072, 1067, 1541, 2479] }
+generate_large_test! { f64, bluesteins_f64, fourier::create_fft_f64, near_f64, [1072, 1067, 1541, 2479] }
+
+#[test]
+fn bluesteins_inner_size() {
+    use fourier_algorithms::bluesteins_inner_size;
+    assert_eq!(bluesteins_inner_size(1), 1);
+    assert_eq!(bluesteins_inner_size(2), 3);
+    assert_eq!(bluesteins_inner_size(1025), 2304);
+    for size in 1..5000 {
+        let inner_size = bluesteins_inner_size(size);
+        assert!(inner_size >= 2 * size - 1);
+        assert!(inner_size <= (2 * size - 1).next_power_of_two());
+        assert!(
+            fourier_algorithms::Autosort::<f32, Vec<Complex<f32>>, Vec<Complex<f32>>>::new(
+                inner_size
+            )
+            .is_some()
+        );
+    }
+}
+
+// The measuring planner may choose any autosort factorization
+macro_rules! generate_factorization_test {
+    {
+        $type:ty, $name:ident, $comparison:ident, $sizes:expr
+    } => {
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            use fourier_algorithms::{autosort_factorizations, Autosort};
+            for size in $sizes.iter().copied() {
+                let distribution = Normal::new(0.0, 1.0 / (size as $type).sqrt()).unwrap();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                let mut dft_output = vec![Complex::default(); size];
+                dft::<$type>(&input, &mut dft_output);
+
+                for (counts, generic_radices) in autosort_factorizations(size) {
+                    println!("SIZE: {} COUNTS: {:?}", size, counts);
+                    let fft = Autosort::<$type, Vec<_>, Vec<_>>::new_with_factors(
+                        size,
+                        counts,
+                        generic_radices,
+                    )
+                    .unwrap();
+                    let mut fft_output = vec![Complex::default(); size];
+                    fft.fft(&input, &mut fft_output);
+                    $comparison(&dft_output, &fft_output);
+                }
+            }
+        }
+    }
+}
+
+generate_factorization_test! { f32, factorizations_f32, near_f32, [2, 64, 96, 512, 2048, 2816] }
+generate_factorization_test! { f64, factorizations_f64, near_f64, [2, 64, 96, 512, 2048, 2816] }
+
+macro_rules! generate_fft_multiply_test {
+    {
+        $type:ty, $name:ident, $comparison:ident, $sizes:expr
+    } => {
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            use fourier_algorithms::{is_autosort_size, Autosort};
+            for size in $sizes.filter(|size| is_autosort_size(*size)) {
+                let distribution = Normal::new(0.0, 1.0 / (size as $type).sqrt()).unwrap();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let mut samples = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .map(|(x, y)| Complex::new(x, y));
+                let input = samples.by_ref().take(size).collect::<Vec<_>>();
+                let factors = samples.take(size).collect::<Vec<_>>();
+
+                let ffts = [
+                    Autosort::<$type, Vec<_>, Vec<_>>::new(size).unwrap(),
+                    Autosort::<$type, Vec<_>, Vec<_>>::new_compact(size).unwrap(),
+                ];
+                for fft in ffts.iter() {
+                    let mut scratch = vec![Complex::default(); fft.scratch_size()];
+                    for conjugate in [false, true].iter().copied() {
+                        // Compare the fused multiply to a separate pass
+                        let mut expected = input.clone();
+                        fft.fft_in_place(&mut expected);
+                        for (x, factor) in expected.iter_mut().zip(&factors) {
+                            *x *= if conjugate { factor.conj() } else { *factor };
+                        }
+                        let mut actual = input.clone();
+                        fft.fft_multiply_in_place_with_scratch(
+                            &mut actual,
+                            &mut scratch,
+                            &factors,
+                            conjugate,
+                        );
+                        $comparison(&actual, &expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+generate_fft_multiply_test! { f32, fft_multiply_f32, near_f32, (1..256).chain(vec![2816, 4096]) }
+generate_fft_multiply_test! { f64, fft_multiply_f64, near_f64, (1..256).chain(vec![2816, 4096]) }
+
+#[cfg(feature = "std")]
+fn create_measured_fft_f32(size: usize) -> Box<dyn fourier::Fft<Real = f32> + Send + Sync> {
+    fourier::create_fft_f32_with_planner(size, fourier::Planner::Measure)
+}
+
+#[cfg(feature = "std")]
+fn create_measured_fft_f64(size: usize) -> Box<dyn fourier::Fft<Real = f64> + Send + Sync> {
+    fourier::create_fft_f64_with_planner(size, fourier::Planner::Measure)
+}
+
+#[cfg(feature = "std")]
+generate_large_test! { f32, measured_f32, create_measured_fft_f32, near_f32, [64, 97, 1000, 1013, 2816] }
+#[cfg(feature = "std")]
+generate_large_test! { f64, measured_f64, create_measured_fft_f64, near_f64, [64, 97, 1000, 1013, 2816] }
+
+// Splitting a transform between threads must not change the result
+macro_rules! generate_threads_test {
+    {
+        $type:ty, $name:ident, $fft_gen:ident, $sizes:expr
+    } => {
+        #[cfg(any(feature = "std", feature = "alloc"))]
+        #[test]
+        fn $name() {
+            use fourier::Fft;
+            for size in $sizes.iter().copied() {
+                println!("SIZE: {}", size);
+                let distribution = Normal::new(0.0, 1.0).unwrap();
+                let rng: StdRng = SeedableRng::seed_from_u64(0xdeadbeef);
+                let input = rng
+                    .sample_iter(&distribution)
+                    .zip(rand::thread_rng().sample_iter(&distribution))
+                    .take(size)
+                    .map(|(x, y)| Complex::new(x, y))
+                    .collect::<Vec<_>>();
+                let fft = $fft_gen(size);
+
+                fourier::set_threads(1);
+                let mut expected = input.clone();
+                let mut scratch = vec![Complex::default(); fft.scratch_size()];
+                fft.transform_in_place_with_scratch(&mut expected, &mut scratch, fourier::Transform::Fft);
+
+                for threads in 2..5 {
+                    fourier::set_threads(threads);
+                    let mut output = input.clone();
+                    fft.fft_in_place(&mut output);
+                    assert!(output == expected);
+
+                    // A scratch buffer sized for fewer threads is still sufficient
+                    let mut output = input.clone();
+                    fft.transform_in_place_with_scratch(&mut output, &mut scratch, fourier::Transform::Fft);
+                    assert!(output == expected);
+                }
+                fourier::set_threads(0);
+            }
+        }
+    }
+}
+
+generate_threads_test! { f32, four_step_threads_f32, create_four_step_f32, [1024, 2816] }
+generate_threads_test! { f64, four_step_threads_f64, create_four_step_f64, [1024, 2816] }
+
+#[cfg(feature = "std")]
+generate_large_test! { f32, cached_f32, fourier::cached_fft_f32, near_f32, [64, 97, 1013, 2816] }
+#[cfg(feature = "std")]
+generate_large_test! { f64, cached_f64, fourier::cached_fft_f64, near_f64, [64, 97, 1013, 2816] }
+
+#[cfg(feature = "std")]
+#[test]
+fn cache_sharing() {
+    use std::sync::Arc;
+    let first = fourier::cached_fft_f32(100);
+    assert!(Arc::ptr_eq(&first, &fourier::cached_fft_f32(100)));
+    assert!(!Arc::ptr_eq(&first, &fourier::cached_fft_f32(101)));
+    assert_eq!(fourier::cached_fft_f64(100).size(), 100);
+
+    // Clearing the cache doesn't invalidate FFTs in use
+    fourier::clear_fft_cache();
+    let second = fourier::cached_fft_f32(100);
+    assert!(!Arc::ptr_eq(&first, &second));
+    assert_eq!(first.size(), second.size());
+}
+
+generate_test! { f32, compact_forward_f32, create_compact_fft_f32, near_f32, true }
+generate_test! { f32, compact_inverse_f32, create_compact_fft_f32, near_f32, false }
+generate_test! { f64, compact_forward_f64, create_compact_fft_f64, near_f64, true }
+generate_test! { f64, compact_inverse_f64, create_compact_fft_f64, near_f64, false }
+generate_large_test! { f32, compact_large_f32, fourier::create_compact_fft_f32, near_f32, [1013, 2816, 4096, 10000] }
+generate_large_test! { f64, compact_large_f64, fourier::create_compact_fft_f64, near_f64, [1013, 2816, 4096, 10000] }
+
+#[cfg(any(feature = "std", feature = "alloc"))]
+#[test]
+fn aligned_vec() {
+    use fourier::{AlignedVec, ALIGNMENT, HUGE_PAGE_SIZE};
+    let mut buffer = AlignedVec::<Complex<f32>>::new();
+    for len in [1, 3, 100, 1000, HUGE_PAGE_SIZE / 8 + 1].iter() {
+        buffer.extend((buffer.len()..*len).map(|i| Complex::new(i as f32, 0.0)));
+        assert_eq!(buffer.len(), *len);
+        assert_eq!(buffer.as_ptr() as usize % ALIGNMENT, 0);
+        assert!(buffer.iter().enumerate().all(|(i, x)| x.re == i as f32));
+    }
+    assert_eq!(buffer.as_ptr() as usize % HUGE_PAGE_SIZE, 0);
+
+    let zeroed = AlignedVec::<Complex<f64>>::zeroed(1000);
+    assert!(zeroed.iter().all(|x| *x == Complex::default()));
+    assert_eq!(zeroed.clone().as_ref(), zeroed.as_ref());
+
+    assert_eq!(
+        AlignedVec::<Complex<f64>>::try_zeroed(1000).unwrap().len(),
+        1000
+    );
+    assert!(AlignedVec::<Complex<f64>>::try_zeroed(std::usize::MAX).is_none());
+    assert!(AlignedVec::<Complex<f64>>::try_zeroed(std::usize::MAX / 32).is_none());
+}
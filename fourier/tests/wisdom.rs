@@ -0,0 +1,65 @@
+// Wisdom is global, so these checks are kept in their own test binary and run sequentially.
+
+use fourier::{Fft, Planner, Transform};
+use num_complex::Complex;
+
+fn transform_f32(fft: &dyn Fft<Real = f32>) -> Vec<Complex<f32>> {
+    let mut input: Vec<_> = (0..fft.size())
+        .map(|i| Complex::new(i as f32, (i % 7) as f32))
+        .collect();
+    fft.transform_in_place(&mut input, Transform::Fft);
+    input
+}
+
+fn transform_f64(fft: &dyn Fft<Real = f64>) -> Vec<Complex<f64>> {
+    let mut input: Vec<_> = (0..fft.size())
+        .map(|i| Complex::new(i as f64, (i % 7) as f64))
+        .collect();
+    fft.transform_in_place(&mut input, Transform::Fft);
+    input
+}
+
+#[test]
+fn wisdom() {
+    fourier::forget_wisdom();
+    let empty = fourier::export_wisdom();
+
+    let sizes = [64, 97, 1013, 2816];
+    let measured_f32: Vec<_> = sizes
+        .iter()
+        .map(|size| {
+            transform_f32(&*fourier::create_fft_f32_with_planner(
+                *size,
+                Planner::Measure,
+            ))
+        })
+        .collect();
+    let measured_f64: Vec<_> = sizes
+        .iter()
+        .map(|size| {
+            transform_f64(&*fourier::create_fft_f64_with_planner(
+                *size,
+                Planner::Measure,
+            ))
+        })
+        .collect();
+    let wisdom = fourier::export_wisdom();
+    assert!(wisdom.len() > empty.len());
+
+    // Malformed wisdom is rejected without being imported
+    fourier::forget_wisdom();
+    assert!(fourier::import_wisdom(b"not wisdom").is_err());
+    assert!(fourier::import_wisdom(&wisdom[..wisdom.len() - 1]).is_err());
+    assert_eq!(fourier::export_wisdom(), empty);
+
+    // The imported decisions are reproduced exactly, by every planner
+    fourier::import_wisdom(&wisdom).unwrap();
+    assert_eq!(fourier::export_wisdom(), wisdom);
+    for (size, expected) in sizes.iter().zip(&measured_f32) {
+        assert_eq!(&transform_f32(&*fourier::create_fft_f32(*size)), expected);
+    }
+    for (size, expected) in sizes.iter().zip(&measured_f64) {
+        assert_eq!(&transform_f64(&*fourier::create_fft_f64(*size)), expected);
+    }
+    assert_eq!(fourier::export_wisdom(), wisdom);
+}